@@ -0,0 +1,355 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <esp_console.h>
+#include <argtable3/argtable3.h>
+#include "bench.h"
+#include "cache_suite.h"
+#include "memory_suite.h"
+#include "dual_core_suite.h"
+
+// One firmware image with every lab suite, driven from an esp_console REPL:
+//
+//   bench list [group]                      registered benchmarks and their grids
+//   bench run cache/stride -p stride=3      any benchmark, parameters set at run time
+//   cache all | cache sweep --min 1k --max 2M
+//   memory info
+//   dualcore run [--transport queue|spsc|pool|mailbox|drop_oldest|varlen]
+//                [--saturate MS [--duty PERCENT] | --periodic US]
+//   dualcore pipeline [--period US] [--capacity N] [--drop] [--duration MS]
+//   dualcore bench
+//   json on|off                             BENCH_JSON records alongside the console output
+
+#define MAX_OVERRIDES 8
+
+// "64", "1k", "2M" -> bytes; returns false on anything else
+static bool parse_size(const char *text, size_t *out) {
+    char *end;
+    unsigned long value = strtoul(text, &end, 0);
+    if(end == text) {
+        return false;
+    }
+    switch(*end) {
+        case 'k': case 'K': value *= 1024; end++; break;
+        case 'm': case 'M': value *= 1024 * 1024; end++; break;
+        default: break;
+    }
+    if(*end != '\0') {
+        return false;
+    }
+    *out = value;
+    return true;
+}
+
+// Run a suite entry point between bench_begin/bench_end so the JSON sink
+// brackets its records like the standalone projects do
+#define RUN_SESSION(group, ...) do { bench_begin(group); __VA_ARGS__; bench_end(group); } while(0)
+
+// ---- bench ----
+
+static struct {
+    struct arg_str *target;
+    struct arg_str *param;
+    struct arg_end *end;
+} bench_run_args;
+
+static void print_grid(const bench_def_t *def) {
+    printf("  %s/%s", def->group, def->name);
+    for(uint32_t p = 0; p < def->param_count; p++) {
+        const bench_param_t *axis = &def->params[p];
+        printf(" %s=", axis->name);
+        for(uint32_t v = 0; v < axis->count; v++) {
+            printf("%s%ld", v ? "," : "", (long)axis->values[v]);
+        }
+    }
+    printf("\n");
+}
+
+static int bench_list(const char *group) {
+    for(const bench_def_t *def = bench_first(); def; def = def->next) {
+        if(group == NULL || strcmp(def->group, group) == 0) {
+            print_grid(def);
+        }
+    }
+    return 0;
+}
+
+// Each -p name=value replaces that axis of the registered grid with the
+// single given value; axes not mentioned keep their full range
+static int bench_run_target(int argc, char **argv) {
+    if(arg_parse(argc, argv, (void **)&bench_run_args) != 0) {
+        arg_print_errors(stderr, bench_run_args.end, argv[0]);
+        return 1;
+    }
+
+    char target[48];
+    strlcpy(target, bench_run_args.target->sval[0], sizeof(target));
+    char *slash = strchr(target, '/');
+    if(slash == NULL) {
+        if(bench_run_args.param->count > 0) {
+            printf("-p needs a single benchmark: group/name\n");
+            return 1;
+        }
+        return bench_run_group(target) > 0 ? 0 : 1;
+    }
+    *slash = '\0';
+
+    const bench_def_t *def = bench_find(target, slash + 1);
+    if(def == NULL) {
+        printf("Unknown benchmark '%s/%s' (see 'bench list')\n", target, slash + 1);
+        return 1;
+    }
+
+    bench_param_t axes[BENCH_MAX_PARAMS];
+    int32_t override_values[MAX_OVERRIDES];
+    memcpy(axes, def->params, sizeof(axes));
+
+    for(int i = 0; i < bench_run_args.param->count && i < MAX_OVERRIDES; i++) {
+        const char *item = bench_run_args.param->sval[i];
+        const char *eq = strchr(item, '=');
+        uint32_t p = 0;
+        size_t value = 0;
+        while(eq && p < def->param_count && (strncmp(def->params[p].name, item, eq - item) != 0 ||
+                                             def->params[p].name[eq - item] != '\0')) {
+            p++;
+        }
+        if(eq == NULL || p == def->param_count || !parse_size(eq + 1, &value)) {
+            printf("Bad parameter '%s' for %s/%s\n", item, def->group, def->name);
+            return 1;
+        }
+        override_values[i] = (int32_t)value;
+        axes[p].values = &override_values[i];
+        axes[p].count = 1;
+    }
+
+    bench_begin(def->group);
+    int cases = bench_run_grid(def, axes);
+    bench_end(def->group);
+    return cases > 0 ? 0 : 1;
+}
+
+static int cmd_bench(int argc, char **argv) {
+    if(argc >= 2 && strcmp(argv[1], "list") == 0) {
+        return bench_list(argc >= 3 ? argv[2] : NULL);
+    }
+    if(argc >= 2 && strcmp(argv[1], "run") == 0) {
+        return bench_run_target(argc - 1, argv + 1);
+    }
+    printf("usage: bench list [group] | bench run <group>[/<name>] [-p name=value]...\n");
+    return 1;
+}
+
+// ---- cache ----
+
+static struct {
+    struct arg_str *min;
+    struct arg_str *max;
+    struct arg_end *end;
+} cache_sweep_args;
+
+static int cmd_cache(int argc, char **argv) {
+    if(argc >= 2 && strcmp(argv[1], "all") == 0) {
+        RUN_SESSION("cache", cache_suite_run_all());
+        return 0;
+    }
+
+    if(argc >= 2 && strcmp(argv[1], "sweep") == 0) {
+        if(arg_parse(argc - 1, argv + 1, (void **)&cache_sweep_args) != 0) {
+            arg_print_errors(stderr, cache_sweep_args.end, "cache sweep");
+            return 1;
+        }
+        size_t min_bytes = CACHE_SWEEP_DEFAULT_MIN;
+        size_t max_bytes = CACHE_SWEEP_DEFAULT_MAX;
+        if((cache_sweep_args.min->count && !parse_size(cache_sweep_args.min->sval[0], &min_bytes)) ||
+           (cache_sweep_args.max->count && !parse_size(cache_sweep_args.max->sval[0], &max_bytes)) ||
+           min_bytes > max_bytes) {
+            printf("Bad sweep range\n");
+            return 1;
+        }
+        RUN_SESSION("cache", cache_suite_init(); cache_suite_sweep(min_bytes, max_bytes));
+        return 0;
+    }
+
+    printf("usage: cache all | cache sweep [--min SIZE] [--max SIZE]\n");
+    return 1;
+}
+
+// ---- dualcore ----
+
+static struct {
+    struct arg_str *transport;
+    struct arg_int *saturate;
+    struct arg_int *duty;
+    struct arg_int *periodic;
+    struct arg_end *end;
+} dualcore_run_args;
+
+static struct {
+    struct arg_int *period;
+    struct arg_int *capacity;
+    struct arg_lit *drop;
+    struct arg_int *duration;
+    struct arg_end *end;
+} dualcore_pipeline_args;
+
+static int dualcore_pipeline(int argc, char **argv) {
+    if(arg_parse(argc, argv, (void **)&dualcore_pipeline_args) != 0) {
+        arg_print_errors(stderr, dualcore_pipeline_args.end, "dualcore pipeline");
+        return 1;
+    }
+    dual_core_pipeline_config_t config = DUAL_CORE_PIPELINE_CONFIG_DEFAULT;
+    if(dualcore_pipeline_args.period->count) {
+        config.period_us = dualcore_pipeline_args.period->ival[0];
+    }
+    if(dualcore_pipeline_args.capacity->count) {
+        config.capacity = dualcore_pipeline_args.capacity->ival[0];
+    }
+    if(dualcore_pipeline_args.duration->count) {
+        config.duration_ms = dualcore_pipeline_args.duration->ival[0];
+    }
+    config.drop = dualcore_pipeline_args.drop->count > 0;
+    if((int32_t)config.period_us <= 0 || (int32_t)config.capacity <= 0 || (int32_t)config.duration_ms <= 0) {
+        printf("--period, --capacity and --duration must be positive\n");
+        return 1;
+    }
+    bool ok;
+    RUN_SESSION("dualcore", ok = dual_core_pipeline_run(&config));
+    return ok ? 0 : 1;
+}
+
+static int cmd_dualcore(int argc, char **argv) {
+    if(argc >= 2 && strcmp(argv[1], "run") == 0) {
+        if(arg_parse(argc - 1, argv + 1, (void **)&dualcore_run_args) != 0) {
+            arg_print_errors(stderr, dualcore_run_args.end, "dualcore run");
+            return 1;
+        }
+        dual_core_config_t config = DUAL_CORE_CONFIG_DEFAULT;
+        if(dualcore_run_args.transport->count &&
+           !dual_core_transport_parse(dualcore_run_args.transport->sval[0], &config.transport)) {
+            printf("Unknown transport '%s'\n", dualcore_run_args.transport->sval[0]);
+            return 1;
+        }
+        if(dualcore_run_args.saturate->count) {
+            if(dualcore_run_args.saturate->ival[0] <= 0) {
+                printf("--saturate needs a duration in ms\n");
+                return 1;
+            }
+            config.mode = DUAL_CORE_MODE_SATURATE;
+            config.duration_ms = dualcore_run_args.saturate->ival[0];
+        }
+        if(dualcore_run_args.duty->count) {
+            config.duty_percent = dualcore_run_args.duty->ival[0];
+        }
+        if(dualcore_run_args.periodic->count) {
+            if(dualcore_run_args.saturate->count || dualcore_run_args.periodic->ival[0] <= 0) {
+                printf("--periodic needs a period in μs and excludes --saturate\n");
+                return 1;
+            }
+            config.mode = DUAL_CORE_MODE_PERIODIC;
+            config.period_us = dualcore_run_args.periodic->ival[0];
+        }
+        bool ok;
+        RUN_SESSION("dualcore", ok = dual_core_suite_run(&config));
+        return ok ? 0 : 1;
+    }
+    if(argc >= 2 && strcmp(argv[1], "pipeline") == 0) {
+        return dualcore_pipeline(argc - 1, argv + 1);
+    }
+    if(argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        RUN_SESSION("dualcore", dual_core_suite_run_benchmarks());
+        return 0;
+    }
+    printf("usage: dualcore run [--transport queue|spsc|pool|mailbox|drop_oldest|varlen]"
+           " [--saturate MS [--duty PERCENT] | --periodic US]"
+           " | dualcore pipeline [--period US] [--capacity N] [--drop] [--duration MS] | dualcore bench\n");
+    return 1;
+}
+
+// ---- memory / json ----
+
+static int cmd_memory(int argc, char **argv) {
+    if(argc >= 2 && strcmp(argv[1], "info") == 0) {
+        RUN_SESSION("memory", memory_suite_run());
+        return 0;
+    }
+    printf("usage: memory info\n");
+    return 1;
+}
+
+static int cmd_json(int argc, char **argv) {
+    if(argc == 2 && (strcmp(argv[1], "on") == 0 || strcmp(argv[1], "off") == 0)) {
+        bench_set_sink(NULL);
+        if(strcmp(argv[1], "on") == 0) {
+            bench_add_sink(&bench_json_sink);
+        }
+        return 0;
+    }
+    printf("usage: json on|off\n");
+    return 1;
+}
+
+static void register_commands(void) {
+    bench_run_args.target = arg_str1(NULL, NULL, "<group>[/<name>]", "benchmark group or single benchmark");
+    bench_run_args.param = arg_strn("p", "param", "<name=value>", 0, MAX_OVERRIDES,
+                                    "fix one grid axis (sizes accept k/M suffixes)");
+    bench_run_args.end = arg_end(4);
+
+    cache_sweep_args.min = arg_str0(NULL, "min", "<size>", "smallest working set (default 1k)");
+    cache_sweep_args.max = arg_str0(NULL, "max", "<size>", "largest working set (default 4M)");
+    cache_sweep_args.end = arg_end(4);
+
+    dualcore_run_args.transport = arg_str0("t", "transport", "<queue|spsc|pool|mailbox|drop_oldest|varlen>",
+                                           "core 0 -> core 1 transport");
+    dualcore_run_args.saturate = arg_int0("s", "saturate", "<ms>", "run both workers unpaced for this long");
+    dualcore_run_args.duty = arg_int0("d", "duty", "<percent>", "busy share of every second when saturating (default 100)");
+    dualcore_run_args.periodic = arg_int0(NULL, "periodic", "<us>", "release both workers on a drift-free grid for 5 s");
+    dualcore_run_args.end = arg_end(4);
+
+    dualcore_pipeline_args.period = arg_int0("p", "period", "<us>", "one item from the source per period (default 1000)");
+    dualcore_pipeline_args.capacity = arg_int0("c", "capacity", "<n>", "depth of every channel (default 16)");
+    dualcore_pipeline_args.drop = arg_lit0(NULL, "drop", "full channels drop items instead of blocking");
+    dualcore_pipeline_args.duration = arg_int0(NULL, "duration", "<ms>", "how long to run (default 5000)");
+    dualcore_pipeline_args.end = arg_end(4);
+
+    const esp_console_cmd_t commands[] = {
+        { .command = "bench", .help = "List or run registered benchmarks",
+          .hint = "list [group] | run <group>[/<name>] [-p name=value]...", .func = cmd_bench },
+        { .command = "cache", .help = "Cache and memory-hierarchy suite",
+          .hint = "all | sweep [--min SIZE] [--max SIZE]", .func = cmd_cache },
+        { .command = "memory", .help = "Memory layout and heap report", .hint = "info", .func = cmd_memory },
+        { .command = "dualcore", .help = "Dual-core producer/consumer workload and transport benchmarks",
+          .hint = "run [--transport queue|spsc|pool|mailbox|drop_oldest|varlen]"
+                  " [--saturate MS [--duty PERCENT] | --periodic US]"
+                  " | pipeline [--period US] [--capacity N] [--drop] [--duration MS] | bench",
+          .func = cmd_dualcore },
+        { .command = "json", .help = "Toggle BENCH_JSON output", .hint = "on|off", .func = cmd_json },
+    };
+
+    for(size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        ESP_ERROR_CHECK(esp_console_cmd_register(&commands[i]));
+    }
+}
+
+void app_main() {
+    printf("ESP32 Architecture Lab - Combined Benchmark Firmware\n");
+    printf("====================================================\n");
+
+    bench_timer_init();
+    printf("CPU clock: %lu MHz, timer overhead: %lu cycles\n",
+           (unsigned long)bench_timer_cpu_mhz(), (unsigned long)bench_timer_overhead_cycles());
+    bench_add_sink(&bench_json_sink);
+
+    esp_console_repl_t *repl = NULL;
+    esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    repl_config.prompt = "bench>";
+    repl_config.task_stack_size = 8192;
+    repl_config.task_core_id = 0;  // the cycle timer needs start and stop on one core
+    esp_console_dev_uart_config_t uart_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+    ESP_ERROR_CHECK(esp_console_new_repl_uart(&uart_config, &repl_config, &repl));
+
+    esp_console_register_help_command();
+    register_commands();
+
+    printf("Type 'help' for commands, 'bench list' for benchmarks\n");
+    ESP_ERROR_CHECK(esp_console_start_repl(repl));
+}
@@ -0,0 +1,213 @@
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static bench_def_t *bench_head = NULL;
+static bench_def_t *bench_tail = NULL;
+static const bench_sink_t *sinks[BENCH_MAX_SINKS] = { &bench_console_sink };
+static int sink_count = 1;
+static int session_cases = 0;
+
+#define FOR_EACH_SINK(callback, ...)                          \
+    for(int s_ = 0; s_ < sink_count; s_++) {                  \
+        if(sinks[s_]->callback) {                             \
+            sinks[s_]->callback(sinks[s_]->ctx, __VA_ARGS__); \
+        }                                                     \
+    }
+
+void bench_register(bench_def_t *def) {
+    def->param_count = 0;
+    while(def->param_count < BENCH_MAX_PARAMS && def->params[def->param_count].name != NULL) {
+        def->param_count++;
+    }
+
+    // Append, so benchmarks run in the order their files define them
+    def->next = NULL;
+    if(bench_tail) {
+        bench_tail->next = def;
+    } else {
+        bench_head = def;
+    }
+    bench_tail = def;
+}
+
+const bench_def_t *bench_first(void) {
+    return bench_head;
+}
+
+const bench_def_t *bench_find(const char *group, const char *name) {
+    for(const bench_def_t *def = bench_head; def; def = def->next) {
+        if(strcmp(def->group, group) == 0 && strcmp(def->name, name) == 0) {
+            return def;
+        }
+    }
+    return NULL;
+}
+
+void bench_set_sink(const bench_sink_t *sink) {
+    sinks[0] = sink ? sink : &bench_console_sink;
+    sink_count = 1;
+}
+
+bool bench_add_sink(const bench_sink_t *sink) {
+    if(sink == NULL || sink_count >= BENCH_MAX_SINKS) {
+        return false;
+    }
+    sinks[sink_count++] = sink;
+    return true;
+}
+
+void bench_report_metric(const char *group, const char *name, const char *params,
+                         const char *unit, double value, bool higher_is_better) {
+    bench_metric_t metric = {
+        .group = group,
+        .name = name,
+        .params = params,
+        .unit = unit,
+        .value = value,
+        .higher_is_better = higher_is_better,
+    };
+    FOR_EACH_SINK(metric, &metric);
+}
+
+void bench_begin(const char *group) {
+    session_cases = 0;
+    FOR_EACH_SINK(begin, group);
+}
+
+void bench_end(const char *group) {
+    FOR_EACH_SINK(end, group, session_cases);
+}
+
+void bench_done(void) {
+    fflush(stdout);
+    printf("\n" BENCH_DONE_MARKER "\n");
+    fflush(stdout);
+}
+
+static void run_trampoline(void *arg) {
+    bench_case_t *c = arg;
+    c->def->run(c);
+}
+
+bool bench_run_case(const bench_def_t *def, const int32_t *values, bench_result_t *result) {
+    bench_case_t c = {
+        .def = def,
+        .config = BENCH_RUN_CONFIG_DEFAULT,
+        .elements = 1,
+    };
+    bench_result_t r = { .def = def };
+
+    memcpy(c.values, values, def->param_count * sizeof(int32_t));
+    memcpy(r.values, values, def->param_count * sizeof(int32_t));
+
+    if(def->setup && !def->setup(&c)) {
+        r.skipped = true;
+    } else {
+        r.skipped = !bench_measure(&c.config, run_trampoline, &c, &r.stats);
+        if(def->teardown) {
+            def->teardown(&c);
+        }
+    }
+
+    r.memory = c.memory;
+    r.elements = c.elements;
+    r.bytes = c.bytes;
+    if(!r.skipped) {
+        session_cases++;
+    }
+    FOR_EACH_SINK(result, &r);
+    if(result) {
+        *result = r;
+    }
+    return !r.skipped;
+}
+
+int bench_run(const bench_def_t *def) {
+    return bench_run_grid(def, def->params);
+}
+
+int bench_run_grid(const bench_def_t *def, const bench_param_t *axes) {
+    int32_t values[BENCH_MAX_PARAMS] = { 0 };
+    uint32_t index[BENCH_MAX_PARAMS] = { 0 };
+    int cases = 0;
+
+    for(uint32_t p = 0; p < def->param_count; p++) {
+        if(axes[p].count == 0) {
+            return 0;
+        }
+    }
+
+    // Odometer over the grid; the last axis varies fastest
+    for(;;) {
+        for(uint32_t p = 0; p < def->param_count; p++) {
+            values[p] = axes[p].values[index[p]];
+        }
+        if(bench_run_case(def, values, NULL)) {
+            cases++;
+        }
+
+        int p = (int)def->param_count - 1;
+        while(p >= 0 && ++index[p] == axes[p].count) {
+            index[p] = 0;
+            p--;
+        }
+        if(p < 0) {
+            break;
+        }
+    }
+    return cases;
+}
+
+int bench_run_group(const char *group) {
+    int cases = 0;
+
+    bench_begin(group);
+    for(const bench_def_t *def = bench_head; def; def = def->next) {
+        if(group == NULL || strcmp(def->group, group) == 0) {
+            cases += bench_run(def);
+        }
+    }
+    bench_end(group);
+    return cases;
+}
+
+// Console sink: the two-line bench_stats_print() summary, prefixed with the
+// grid point, plus MB/s for benchmarks that report bytes moved
+static void console_result(void *ctx, const bench_result_t *r) {
+    char label[96];
+    int len = snprintf(label, sizeof(label), "%s/%s", r->def->group, r->def->name);
+
+    for(uint32_t p = 0; p < r->def->param_count && len < (int)sizeof(label); p++) {
+        len += snprintf(label + len, sizeof(label) - len, " %s=%ld", r->def->params[p].name, (long)r->values[p]);
+    }
+    if(r->memory && len < (int)sizeof(label)) {
+        snprintf(label + len, sizeof(label) - len, " [%s]", r->memory);
+    }
+
+    if(r->skipped) {
+        printf("%s: skipped\n", label);
+        return;
+    }
+
+    bench_stats_print(label, &r->stats, r->elements);
+    if(r->bytes > 0 && r->stats.min > 0) {
+        // bytes per μs == MB/s (10^6 bytes)
+        printf("    bandwidth: %.1f MB/s median, %.1f MB/s best\n",
+               r->bytes / bench_cycles_to_us((uint64_t)r->stats.median),
+               r->bytes / bench_cycles_to_us(r->stats.min));
+    }
+}
+
+static void console_end(void *ctx, const char *group, int cases) {
+    if(cases == 0) {
+        return;  // session carried metrics only
+    }
+    printf("%d benchmark case(s) run in group '%s'\n", cases, group ? group : "all");
+}
+
+const bench_sink_t bench_console_sink = {
+    .result = console_result,
+    .end = console_end,
+};
@@ -0,0 +1,80 @@
+#include "bench_hist.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+
+void bench_hist_reset(bench_hist_t *hist) {
+    memset(hist, 0, sizeof(*hist));
+    hist->min = UINT32_MAX;
+}
+
+void bench_hist_merge(bench_hist_t *dst, const bench_hist_t *src) {
+    for(uint32_t i = 0; i < BENCH_HIST_BUCKETS; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if(src->min < dst->min) {
+        dst->min = src->min;
+    }
+    if(src->max > dst->max) {
+        dst->max = src->max;
+    }
+}
+
+// Largest value that maps to bucket `index`
+static uint32_t bucket_upper(uint32_t index) {
+    if(index < BENCH_HIST_SUB_BUCKETS) {
+        return index;
+    }
+    uint32_t shift = index / BENCH_HIST_SUB_BUCKETS - 1;
+    uint32_t sub = index % BENCH_HIST_SUB_BUCKETS + BENCH_HIST_SUB_BUCKETS;
+    return (uint32_t)((((uint64_t)sub + 1) << shift) - 1);
+}
+
+uint32_t bench_hist_percentile(const bench_hist_t *hist, double pct) {
+    if(hist->count == 0) {
+        return 0;
+    }
+
+    uint32_t rank = (uint32_t)ceil(pct / 100.0 * hist->count);
+    if(rank < 1) {
+        rank = 1;
+    }
+
+    uint32_t seen = 0;
+    for(uint32_t i = 0; i < BENCH_HIST_BUCKETS; i++) {
+        seen += hist->counts[i];
+        if(seen >= rank) {
+            uint32_t upper = bucket_upper(i);
+            return upper < hist->max ? upper : hist->max;
+        }
+    }
+    return hist->max;  // a concurrent writer bumped `count` before its bucket
+}
+
+void bench_hist_print(const char *label, const bench_hist_t *hist, const char *unit) {
+    printf("%s: n %lu, p50 %lu, p90 %lu, p99 %lu, p99.9 %lu, max %lu %s\n", label,
+           (unsigned long)hist->count,
+           (unsigned long)bench_hist_percentile(hist, 50.0),
+           (unsigned long)bench_hist_percentile(hist, 90.0),
+           (unsigned long)bench_hist_percentile(hist, 99.0),
+           (unsigned long)bench_hist_percentile(hist, 99.9),
+           (unsigned long)(hist->count ? hist->max : 0), unit);
+}
+
+void bench_hist_report(const char *group, const char *name, const char *params, const char *unit,
+                       const bench_hist_t *hist) {
+    static const struct {
+        const char *suffix;
+        double pct;
+    } points[] = { { "p50", 50.0 }, { "p90", 90.0 }, { "p99", 99.0 }, { "p999", 99.9 }, { "max", 100.0 } };
+    char metric[48];
+
+    for(size_t i = 0; i < sizeof(points) / sizeof(points[0]); i++) {
+        snprintf(metric, sizeof(metric), "%s_%s", name, points[i].suffix);
+        bench_report_metric(group, metric, params, unit, bench_hist_percentile(hist, points[i].pct), false);
+    }
+}
@@ -0,0 +1,90 @@
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Records are flat JSON objects, one per line:
+//   BENCH_JSON {"type":"result","group":"cache","name":"stride","params":{"stride":4},...}
+// Identifiers come from string literals in the firmware, so they are written
+// without escaping.
+
+static void json_begin(void *ctx, const char *group) {
+    printf(BENCH_JSON_PREFIX "{\"type\":\"begin\",\"group\":\"%s\",\"cpu_mhz\":%lu}\n",
+           group ? group : "all", (unsigned long)bench_timer_cpu_mhz());
+}
+
+static void json_result(void *ctx, const bench_result_t *r) {
+    printf(BENCH_JSON_PREFIX "{\"type\":\"result\",\"group\":\"%s\",\"name\":\"%s\",\"params\":{",
+           r->def->group, r->def->name);
+    for(uint32_t p = 0; p < r->def->param_count; p++) {
+        printf("%s\"%s\":%ld", p ? "," : "", r->def->params[p].name, (long)r->values[p]);
+    }
+    printf("},\"memory\":\"%s\",\"cpu_mhz\":%lu", r->memory ? r->memory : "", (unsigned long)bench_timer_cpu_mhz());
+
+    if(r->skipped) {
+        printf(",\"skipped\":true}\n");
+        return;
+    }
+
+    const bench_stats_t *st = &r->stats;
+    double elements = r->elements > 0 ? (double)r->elements : 1.0;
+    printf(",\"elements\":%llu,\"bytes\":%llu,\"runs\":%lu,\"converged\":%s",
+           r->elements, r->bytes, (unsigned long)st->runs, st->converged ? "true" : "false");
+    printf(",\"cycles\":{\"min\":%llu,\"median\":%.1f,\"mean\":%.1f,\"stddev\":%.1f,"
+           "\"p95\":%.1f,\"p99\":%.1f,\"max\":%llu,\"ci95\":%.1f}",
+           st->min, st->median, st->mean, st->stddev, st->p95, st->p99, st->max, st->ci95);
+    printf(",\"cycles_per_op\":%.4f,\"ns_per_op\":%.4f",
+           st->median / elements, bench_cycles_to_ns((uint64_t)st->median) / elements);
+    if(r->bytes > 0 && st->median > 0) {
+        printf(",\"mbps\":%.2f", r->bytes / bench_cycles_to_us((uint64_t)st->median));
+    }
+    printf("}\n");
+}
+
+static void json_metric(void *ctx, const bench_metric_t *m) {
+    printf(BENCH_JSON_PREFIX "{\"type\":\"metric\",\"group\":\"%s\",\"name\":\"%s\",\"params\":{",
+           m->group, m->name);
+
+    // "key=value key=value" -> {"key":value,...}; non-numeric values are quoted
+    const char *p = m->params;
+    int first = 1;
+    while(p && *p) {
+        while(*p == ' ') {
+            p++;
+        }
+        const char *eq = p;
+        while(*eq && *eq != '=' && *eq != ' ') {
+            eq++;
+        }
+        if(*eq != '=') {
+            break;
+        }
+        const char *value = eq + 1;
+        const char *end = value;
+        while(*end && *end != ' ') {
+            end++;
+        }
+
+        char *parsed_end;
+        strtod(value, &parsed_end);
+        int numeric = end > value && parsed_end == end;
+        printf("%s\"%.*s\":%s%.*s%s", first ? "" : ",", (int)(eq - p), p,
+               numeric ? "" : "\"", (int)(end - value), value, numeric ? "" : "\"");
+        first = 0;
+        p = end;
+    }
+
+    printf("},\"unit\":\"%s\",\"value\":%.4f,\"higher_is_better\":%s}\n",
+           m->unit, m->value, m->higher_is_better ? "true" : "false");
+}
+
+static void json_end(void *ctx, const char *group, int cases) {
+    printf(BENCH_JSON_PREFIX "{\"type\":\"end\",\"group\":\"%s\",\"cases\":%d}\n", group ? group : "all", cases);
+}
+
+const bench_sink_t bench_json_sink = {
+    .begin = json_begin,
+    .result = json_result,
+    .metric = json_metric,
+    .end = json_end,
+};
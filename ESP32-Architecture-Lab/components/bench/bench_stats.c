@@ -0,0 +1,131 @@
+#include "bench_stats.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_timer.h"
+
+// Two-sided 95% Student t critical values for 1..30 degrees of freedom;
+// beyond that the normal approximation (1.96) is within 2%
+static const double t_table_95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+static double t_critical_95(uint32_t degrees_of_freedom) {
+    if(degrees_of_freedom == 0) {
+        return INFINITY;
+    }
+    if(degrees_of_freedom <= sizeof(t_table_95) / sizeof(t_table_95[0])) {
+        return t_table_95[degrees_of_freedom - 1];
+    }
+    return 1.96;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile over sorted samples
+static double percentile(const uint64_t *sorted, uint32_t count, double p) {
+    uint32_t rank = (uint32_t)ceil(p / 100.0 * count);
+    if(rank < 1) {
+        rank = 1;
+    }
+    return (double)sorted[rank - 1];
+}
+
+// Running mean/variance (Welford) so convergence can be checked every run
+typedef struct {
+    uint32_t n;
+    double mean;
+    double m2;
+} running_stats_t;
+
+static void running_add(running_stats_t *r, double x) {
+    r->n++;
+    double delta = x - r->mean;
+    r->mean += delta / r->n;
+    r->m2 += delta * (x - r->mean);
+}
+
+static double running_ci95(const running_stats_t *r) {
+    if(r->n < 2) {
+        return INFINITY;
+    }
+    double stddev = sqrt(r->m2 / (r->n - 1));
+    return t_critical_95(r->n - 1) * stddev / sqrt(r->n);
+}
+
+void bench_stats_compute(uint64_t *samples, uint32_t count, bench_stats_t *stats) {
+    running_stats_t r = { 0 };
+
+    stats->runs = count;
+    if(count == 0) {
+        return;
+    }
+
+    qsort(samples, count, sizeof(samples[0]), compare_u64);
+    for(uint32_t i = 0; i < count; i++) {
+        running_add(&r, (double)samples[i]);
+    }
+
+    stats->min = samples[0];
+    stats->max = samples[count - 1];
+    stats->median = (count % 2) ? (double)samples[count / 2]
+                                : (samples[count / 2 - 1] + samples[count / 2]) / 2.0;
+    stats->mean = r.mean;
+    stats->stddev = count > 1 ? sqrt(r.m2 / (count - 1)) : 0.0;
+    stats->p95 = percentile(samples, count, 95.0);
+    stats->p99 = percentile(samples, count, 99.0);
+    stats->ci95 = running_ci95(&r);
+}
+
+bool bench_measure(const bench_run_config_t *config, bench_run_fn_t fn, void *arg, bench_stats_t *stats) {
+    uint32_t max_runs = config->max_runs > 0 ? config->max_runs : 1;
+    uint64_t *samples = malloc(max_runs * sizeof(uint64_t));
+    if(samples == NULL) {
+        return false;
+    }
+
+    for(uint32_t i = 0; i < config->warmup_runs; i++) {
+        fn(arg);
+    }
+
+    running_stats_t r = { 0 };
+    bool converged = false;
+    uint32_t count = 0;
+
+    while(count < max_runs) {
+        bench_timer_t timer;
+        bench_timer_start(&timer);
+        fn(arg);
+        samples[count] = bench_timer_stop(&timer);
+        running_add(&r, (double)samples[count]);
+        count++;
+
+        if(count >= config->min_runs && r.mean > 0 && running_ci95(&r) <= config->target_ci * r.mean) {
+            converged = true;
+            break;
+        }
+    }
+
+    bench_stats_compute(samples, count, stats);
+    stats->converged = converged;
+    free(samples);
+    return true;
+}
+
+void bench_stats_print(const char *label, const bench_stats_t *stats, uint64_t elements_per_run) {
+    double scale = elements_per_run > 0 ? (double)elements_per_run : 1.0;
+
+    printf("%s: %.1f μs/run, %.3f cycles/%s (median)\n", label, bench_cycles_to_us((uint64_t)stats->median),
+           stats->median / scale, elements_per_run > 1 ? "element" : "run");
+    printf("    cycles/run: min %llu, mean %.0f ± %.0f, p95 %.0f, p99 %.0f, max %llu | %lu runs, CI95 ±%.2f%%%s\n",
+           stats->min, stats->mean, stats->stddev, stats->p95, stats->p99, stats->max,
+           (unsigned long)stats->runs, stats->mean > 0 ? 100.0 * stats->ci95 / stats->mean : 0.0,
+           stats->converged ? "" : " (not converged)");
+}
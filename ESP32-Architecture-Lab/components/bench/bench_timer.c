@@ -0,0 +1,60 @@
+#include "bench_timer.h"
+
+#include <esp_rom_sys.h>
+
+#define CALIBRATION_ROUNDS 64
+
+static uint32_t timer_overhead = 0;
+
+void bench_timer_init(void) {
+    uint64_t best = UINT64_MAX;
+
+    // Minimum, not mean: the overhead is a fixed instruction sequence and
+    // anything above the minimum is an interrupt landing in the window
+    for(int i = 0; i < CALIBRATION_ROUNDS; i++) {
+        bench_timer_t timer;
+        bench_timer_start(&timer);
+        uint64_t cycles = bench_timer_stop_raw(&timer);
+        if(cycles < best) {
+            best = cycles;
+        }
+    }
+
+    timer_overhead = (uint32_t)best;
+}
+
+uint64_t bench_timer_unwrap(uint32_t delta_cycles, int64_t delta_us) {
+    // Cycles the microsecond clock says have passed. Short intervals (the
+    // common case) cannot have wrapped and skip the correction entirely.
+    uint64_t expected = (uint64_t)(delta_us > 0 ? delta_us : 0) * bench_timer_cpu_mhz();
+    if(expected < (1ULL << 31)) {
+        return delta_cycles;
+    }
+
+    // Choose the number of whole wraps that brings the 32-bit delta closest
+    // to the expected value; esp_timer's jitter is far below half a wrap
+    int64_t missing = (int64_t)expected - (int64_t)delta_cycles + (1LL << 31);
+    uint64_t wraps = missing > 0 ? (uint64_t)missing >> 32 : 0;
+    return delta_cycles + (wraps << 32);
+}
+
+uint64_t bench_timer_stop(const bench_timer_t *timer) {
+    uint64_t cycles = bench_timer_stop_raw(timer);
+    return cycles > timer_overhead ? cycles - timer_overhead : 0;
+}
+
+uint32_t bench_timer_overhead_cycles(void) {
+    return timer_overhead;
+}
+
+uint32_t bench_timer_cpu_mhz(void) {
+    return esp_rom_get_cpu_ticks_per_us();
+}
+
+double bench_cycles_to_us(uint64_t cycles) {
+    return (double)cycles / bench_timer_cpu_mhz();
+}
+
+double bench_cycles_to_ns(uint64_t cycles) {
+    return (double)cycles * 1000.0 / bench_timer_cpu_mhz();
+}
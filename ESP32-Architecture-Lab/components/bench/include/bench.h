@@ -0,0 +1,141 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "bench_hist.h"
+#include "bench_stats.h"
+#include "bench_timer.h"
+
+// Benchmark registry, parameter grids and result sinks.
+//
+// A benchmark is a bench_def_t registered at startup with BENCH_DEFINE. Each
+// point of its parameter grid becomes a bench_case_t: setup() prepares state
+// for that point, run() is one timed run, and teardown() releases the state.
+// bench_measure() handles warm-up and repetition, and every result goes to the
+// active sink, so each benchmark gets the same statistics and output format.
+
+#define BENCH_MAX_PARAMS 4
+
+typedef struct {
+    const char *name;
+    const int32_t *values;
+    uint32_t count;
+} bench_param_t;
+
+// BENCH_PARAM("stride", 1, 2, 4) declares one grid axis
+#define BENCH_PARAM(name_, ...)                                                   \
+    { .name = (name_), .values = (const int32_t[]){ __VA_ARGS__ },              \
+      .count = sizeof((const int32_t[]){ __VA_ARGS__ }) / sizeof(int32_t) }
+
+struct bench_def;
+
+typedef struct {
+    const struct bench_def *def;
+    int32_t values[BENCH_MAX_PARAMS];  // this grid point, in `params` order
+    bench_run_config_t config;         // defaults; setup() may adjust
+    uint64_t elements;                 // work items per run, for cycles/element
+    uint64_t bytes;                    // bytes moved per run, for MB/s (0 = not reported)
+    const char *memory;                // memory region label, optional
+    void *state;                       // owned by the benchmark
+} bench_case_t;
+
+typedef struct bench_def {
+    const char *group;
+    const char *name;
+    bool (*setup)(bench_case_t *c);     // optional; false skips this grid point
+    void (*run)(bench_case_t *c);       // one timed run
+    void (*teardown)(bench_case_t *c);  // optional
+    bench_param_t params[BENCH_MAX_PARAMS];
+    uint32_t param_count;               // filled in by bench_register()
+    struct bench_def *next;
+} bench_def_t;
+
+typedef struct {
+    const bench_def_t *def;
+    int32_t values[BENCH_MAX_PARAMS];
+    const char *memory;
+    uint64_t elements;
+    uint64_t bytes;
+    bool skipped;
+    bench_stats_t stats;
+} bench_result_t;
+
+// A single measured value that does not come from bench_measure(), e.g. a
+// sweep point, a heap size or a workload average. `params` is a
+// space-separated "key=value" list and may be NULL.
+typedef struct {
+    const char *group;
+    const char *name;
+    const char *params;
+    const char *unit;
+    double value;
+    bool higher_is_better;
+} bench_metric_t;
+
+// Every callback is optional
+typedef struct {
+    void (*begin)(void *ctx, const char *group);
+    void (*result)(void *ctx, const bench_result_t *result);
+    void (*metric)(void *ctx, const bench_metric_t *metric);
+    void (*end)(void *ctx, const char *group, int cases);
+    void *ctx;
+} bench_sink_t;
+
+// Defines `id_` and registers it before app_main runs. Parameter axes follow
+// the callbacks as BENCH_PARAM(...) entries.
+#define BENCH_DEFINE(id_, group_, name_, setup_, run_, teardown_, ...)           \
+    bench_def_t id_ = { .group = (group_), .name = (name_), .setup = (setup_),  \
+                        .run = (run_), .teardown = (teardown_),                 \
+                        .params = { __VA_ARGS__ } };                            \
+    static void __attribute__((constructor)) bench_register_##id_(void) {       \
+        bench_register(&id_);                                                   \
+    }
+
+void bench_register(bench_def_t *def);
+const bench_def_t *bench_first(void);
+const bench_def_t *bench_find(const char *group, const char *name);
+
+#define BENCH_MAX_SINKS 4
+
+// Route results to `sink` only; NULL restores the console sink
+void bench_set_sink(const bench_sink_t *sink);
+
+// Route results to `sink` in addition to the current sinks
+bool bench_add_sink(const bench_sink_t *sink);
+
+// Human-readable summary (default). Metrics are not printed: callers of
+// bench_report_metric() print their own human-readable line.
+extern const bench_sink_t bench_console_sink;
+
+// One JSON object per line, prefixed with BENCH_JSON_PREFIX so records can be
+// picked out of a serial log; see tools/bench_compare.py
+#define BENCH_JSON_PREFIX "BENCH_JSON "
+extern const bench_sink_t bench_json_sink;
+
+// Printed once by bench_done() when a program has finished all its
+// measurements; tools/run_qemu_bench.py stops capturing when it sees it
+#define BENCH_DONE_MARKER "BENCH_DONE"
+void bench_done(void);
+
+// Report a value measured outside the framework to every sink
+void bench_report_metric(const char *group, const char *name, const char *params,
+                         const char *unit, double value, bool higher_is_better);
+
+// Bracket a session of results for the sinks (the JSON sink writes begin/end
+// records); bench_end() reports the number of cases run since bench_begin()
+void bench_begin(const char *group);
+void bench_end(const char *group);
+
+// Run one grid point and report it to the sink. `result` may be NULL.
+bool bench_run_case(const bench_def_t *def, const int32_t *values, bench_result_t *result);
+
+// Run every grid point of `def`; returns the number of cases run
+int bench_run(const bench_def_t *def);
+
+// Same, over `axes` (def->param_count entries, in def->params order) instead
+// of the registered grid; used to override parameters at run time
+int bench_run_grid(const bench_def_t *def, const bench_param_t *axes);
+
+// Run every benchmark in `group` (NULL for all) in registration order,
+// bracketed by bench_begin()/bench_end()
+int bench_run_group(const char *group);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+
+// Fixed-memory latency histogram with log-linear buckets (HDR-histogram
+// style). Values below 2^BENCH_HIST_SUB_BITS get one bucket each; above that
+// every power of two is split into 2^BENCH_HIST_SUB_BITS equal buckets, so
+// any recorded value is known to within 1/16 (6.25%) over the whole 32-bit
+// range in under 2 KB. Recording never allocates and costs one CLZ, a shift
+// and an increment, so it can sit on the hot path of a task.
+//
+// One histogram has one writer. Give each task its own and combine them with
+// bench_hist_merge(); a reader on another core may see a record half-applied
+// (count updated, bucket not yet), which shifts a percentile by at most one
+// sample.
+
+#define BENCH_HIST_SUB_BITS 4
+#define BENCH_HIST_SUB_BUCKETS (1u << BENCH_HIST_SUB_BITS)
+#define BENCH_HIST_BUCKETS (BENCH_HIST_SUB_BUCKETS * (32 - BENCH_HIST_SUB_BITS + 1))
+
+typedef struct {
+    uint32_t counts[BENCH_HIST_BUCKETS];
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} bench_hist_t;
+
+void bench_hist_reset(bench_hist_t *hist);
+
+static inline uint32_t bench_hist_bucket(uint32_t value) {
+    if(value < BENCH_HIST_SUB_BUCKETS) {
+        return value;
+    }
+    uint32_t shift = (31 - __builtin_clz(value)) - BENCH_HIST_SUB_BITS;
+    return BENCH_HIST_SUB_BUCKETS * (shift + 1) + ((value >> shift) - BENCH_HIST_SUB_BUCKETS);
+}
+
+static inline void bench_hist_record(bench_hist_t *hist, uint32_t value) {
+    hist->counts[bench_hist_bucket(value)]++;
+    hist->sum += value;
+    if(value < hist->min) {
+        hist->min = value;
+    }
+    if(value > hist->max) {
+        hist->max = value;
+    }
+    hist->count++;
+}
+
+// Add every sample of `src` to `dst`
+void bench_hist_merge(bench_hist_t *dst, const bench_hist_t *src);
+
+// Value at or below which `pct` percent of the samples fall (nearest rank),
+// reported as the upper edge of its bucket and capped at the maximum; 0 for
+// an empty histogram
+uint32_t bench_hist_percentile(const bench_hist_t *hist, double pct);
+
+// "label: n 123, p50 .. p90 .. p99 .. p99.9 .. max .. unit"
+void bench_hist_print(const char *label, const bench_hist_t *hist, const char *unit);
+
+// Report p50/p90/p99/p99.9/max as metrics <name>_p50, <name>_p90, ...
+void bench_hist_report(const char *group, const char *name, const char *params, const char *unit,
+                       const bench_hist_t *hist);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Per-run statistics with warm-up and adaptive repetition.
+//
+// bench_measure() runs a kernel `warmup_runs` times untimed, then times each
+// run on its own until the 95% confidence interval of the mean is within
+// `target_ci` of the mean (after at least `min_runs`) or `max_runs` is hit.
+
+typedef struct {
+    uint32_t warmup_runs;  // untimed runs to fill caches and settle branch history
+    uint32_t min_runs;
+    uint32_t max_runs;
+    double target_ci;      // relative 95% CI half-width, e.g. 0.01 for +-1%
+} bench_run_config_t;
+
+#define BENCH_RUN_CONFIG_DEFAULT { .warmup_runs = 2, .min_runs = 5, .max_runs = 100, .target_ci = 0.01 }
+
+// All values in cycles per run
+typedef struct {
+    uint32_t runs;
+    uint64_t min;
+    uint64_t max;
+    double median;
+    double mean;
+    double stddev;
+    double p95;
+    double p99;
+    double ci95;     // half-width of the 95% confidence interval of the mean
+    bool converged;  // ci95 reached target_ci before max_runs
+} bench_stats_t;
+
+typedef void (*bench_run_fn_t)(void *arg);
+
+// Time `fn(arg)` repeatedly per `config`. Returns false if the sample buffer
+// cannot be allocated.
+bool bench_measure(const bench_run_config_t *config, bench_run_fn_t fn, void *arg, bench_stats_t *stats);
+
+// Compute statistics over `count` samples (cycles). Sorts `samples` in place.
+void bench_stats_compute(uint64_t *samples, uint32_t count, bench_stats_t *stats);
+
+// Two-line human-readable summary; `elements_per_run` scales the headline
+// to cycles/element (pass 1 to report cycles/run)
+void bench_stats_print(const char *label, const bench_stats_t *stats, uint64_t elements_per_run);
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+#include <esp_cpu.h>
+#include <esp_timer.h>
+
+// Cycle-accurate interval timer built on the CPU cycle counter (CCOUNT).
+//
+// CCOUNT is 32 bits and wraps every 2^32 cycles (26.8 s at 160 MHz), so each
+// timestamp also records esp_timer_get_time(); intervals longer than one wrap
+// are resolved against the microsecond clock. The counter is per core: start
+// and stop must run on the same core, i.e. from a task pinned to one core.
+
+typedef struct {
+    int64_t us;
+    uint32_t cycles;
+} bench_timer_t;
+
+// Extend a 32-bit cycle delta to 64 bits using the microsecond delta taken
+// over the same interval
+uint64_t bench_timer_unwrap(uint32_t delta_cycles, int64_t delta_us);
+
+// Measure the fixed cost of an empty start/stop pair. Call once at startup,
+// before any measurement; bench_timer_stop() subtracts it from every interval.
+void bench_timer_init(void);
+
+static inline void bench_timer_start(bench_timer_t *timer) {
+    timer->us = esp_timer_get_time();
+    timer->cycles = esp_cpu_get_cycle_count();  // read last: innermost edge of the window
+}
+
+// Raw cycles since bench_timer_start(), without overhead correction
+static inline uint64_t bench_timer_stop_raw(const bench_timer_t *timer) {
+    uint32_t cycles = esp_cpu_get_cycle_count();  // read first: innermost edge of the window
+    int64_t us = esp_timer_get_time();
+    return bench_timer_unwrap(cycles - timer->cycles, us - timer->us);
+}
+
+// Elapsed cycles since bench_timer_start(), minus the calibrated overhead
+uint64_t bench_timer_stop(const bench_timer_t *timer);
+
+uint32_t bench_timer_overhead_cycles(void);
+uint32_t bench_timer_cpu_mhz(void);
+double bench_cycles_to_us(uint64_t cycles);
+double bench_cycles_to_ns(uint64_t cycles);
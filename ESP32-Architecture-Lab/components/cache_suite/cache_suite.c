@@ -0,0 +1,879 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+#include <esp_attr.h>
+#include "bench.h"
+#include "parallel.h"
+#include "cache_suite.h"
+
+#define ARRAY_SIZE 4096
+#define ITERATIONS 100
+#define TEST_RUNS 5          // minimum timed runs; more are added until the CI95 is within 1%
+
+// Working-set sweep: two points per octave (2^k and 1.5 * 2^k)
+#define ENABLE_WORKING_SET_SWEEP 1
+#define SWEEP_MAX_POINTS 48
+#define SWEEP_TARGET_ACCESSES (1024 * 1024)  // accesses per point, spread over passes
+#define SWEEP_KNEE_RATIO 1.25                // slowdown vs. current plateau that marks a knee
+
+// Pointer chasing: every load's address is the value of the previous load
+#define CHASE_SRAM_BYTES (32 * 1024)
+#define CHASE_PSRAM_BYTES (512 * 1024)
+#define CHASE_FLASH_ENTRIES 32768u            // 128 KB of rodata, 4x the 32 KB flash cache
+#define CHASE_LOADS (256 * 1024)              // timed loads per region, multiple of 8
+
+// STREAM-style bandwidth: each region is split into three arrays a, b, c
+#define BW_PSRAM_BYTES (192 * 1024)           // 64 KB per array, twice the cache
+#define BW_DMA_BYTES (24 * 1024)
+#define BW_RTC_WORDS 768                      // 3 KB of the 8 KB RTC fast memory
+#define BW_TARGET_BYTES (4 * 1024 * 1024)     // traffic per timed run
+#define BW_REPEATS 5                          // minimum runs; "best" is reported as STREAM does
+#define BW_SCALAR 3u
+
+// Test arrays in different memory locations
+static uint32_t sram_array[ARRAY_SIZE];
+static uint32_t *psram_array = NULL;
+
+// RTC fast memory is only reachable from PRO_CPU on the ESP32; app_main runs there
+static RTC_FAST_ATTR uint32_t rtc_fast_array[BW_RTC_WORDS];
+static volatile uint32_t result_sink;  // keeps loop results observable
+
+// Flash-resident chase table. Entry i points at entry (a*i + c) mod 2^k; with
+// c odd and a = 1 (mod 4) that LCG has full period, so following the pointers
+// visits all CHASE_FLASH_ENTRIES entries in one pseudo-random cycle. It has to
+// be built at compile time because rodata cannot be shuffled at run time.
+#define CHASE_NEXT(i) &flash_chase_table[((i) * 1103515245u + 12345u) & (CHASE_FLASH_ENTRIES - 1)],
+#define CHASE_R2(i) CHASE_NEXT(i) CHASE_NEXT((i) + 1)
+#define CHASE_R4(i) CHASE_R2(i) CHASE_R2((i) + 2)
+#define CHASE_R8(i) CHASE_R4(i) CHASE_R4((i) + 4)
+#define CHASE_R16(i) CHASE_R8(i) CHASE_R8((i) + 8)
+#define CHASE_R32(i) CHASE_R16(i) CHASE_R16((i) + 16)
+#define CHASE_R64(i) CHASE_R32(i) CHASE_R32((i) + 32)
+#define CHASE_R128(i) CHASE_R64(i) CHASE_R64((i) + 64)
+#define CHASE_R256(i) CHASE_R128(i) CHASE_R128((i) + 128)
+#define CHASE_R512(i) CHASE_R256(i) CHASE_R256((i) + 256)
+#define CHASE_R1K(i) CHASE_R512(i) CHASE_R512((i) + 512)
+#define CHASE_R2K(i) CHASE_R1K(i) CHASE_R1K((i) + 1024)
+#define CHASE_R4K(i) CHASE_R2K(i) CHASE_R2K((i) + 2048)
+#define CHASE_R8K(i) CHASE_R4K(i) CHASE_R4K((i) + 4096)
+#define CHASE_R16K(i) CHASE_R8K(i) CHASE_R8K((i) + 8192)
+#define CHASE_R32K(i) CHASE_R16K(i) CHASE_R16K((i) + 16384)
+
+static const void *const flash_chase_table[CHASE_FLASH_ENTRIES] = { CHASE_R32K(0u) };
+_Static_assert(CHASE_FLASH_ENTRIES == 32768u, "CHASE_R32K expansion assumes 32768 entries");
+
+// Memory regions for the access benchmarks ("mem" parameter)
+enum { MEM_SRAM, MEM_EXTERNAL };
+static const char *const memory_names[] = { "SRAM", "External" };
+
+// Performance measurement functions
+// One timed run is ITERATIONS passes over the array; the bench framework
+// repeats runs (at least TEST_RUNS) until the median is stable.
+typedef struct {
+    const uint32_t *array;
+    int stride;
+    uint32_t sum;
+} access_run_t;
+
+static bool access_setup(bench_case_t *c, const uint32_t *array, int stride) {
+    if(array == NULL) {
+        return false;
+    }
+
+    access_run_t *run = calloc(1, sizeof(access_run_t));
+    if(run == NULL) {
+        return false;
+    }
+    run->array = array;
+    run->stride = stride;
+    c->state = run;
+    c->elements = (uint64_t)ITERATIONS * ((ARRAY_SIZE + stride - 1) / stride);
+    c->config.min_runs = TEST_RUNS;
+    return true;
+}
+
+static bool memory_access_setup(bench_case_t *c) {
+    int32_t mem = c->values[0];
+    if(mem != MEM_SRAM && mem != MEM_EXTERNAL) {
+        return false;
+    }
+    c->memory = memory_names[mem];
+    return access_setup(c, mem == MEM_SRAM ? sram_array : psram_array, 1);
+}
+
+static bool stride_access_setup(bench_case_t *c) {
+    if(c->values[0] < 1 || c->values[0] > ARRAY_SIZE) {
+        return false;
+    }
+    c->memory = memory_names[MEM_SRAM];
+    return access_setup(c, sram_array, c->values[0]);
+}
+
+static void access_teardown(bench_case_t *c) {
+    access_run_t *run = c->state;
+    result_sink = run->sum;
+    free(run);
+}
+
+static void sequential_run(bench_case_t *c) {
+    access_run_t *run = c->state;
+    uint32_t sum = run->sum;
+    for(int iter = 0; iter < ITERATIONS; iter++) {
+        for(int i = 0; i < ARRAY_SIZE; i++) {
+            sum += run->array[i];
+        }
+    }
+    run->sum = sum;
+}
+
+static void random_run(bench_case_t *c) {
+    access_run_t *run = c->state;
+    uint32_t sum = run->sum;
+    for(int iter = 0; iter < ITERATIONS; iter++) {
+        for(int i = 0; i < ARRAY_SIZE; i++) {
+            // Pseudo-random index to break cache locality
+            int index = (i * 2654435761U) % ARRAY_SIZE;
+            sum += run->array[index];
+        }
+    }
+    run->sum = sum;
+}
+
+static void stride_run(bench_case_t *c) {
+    access_run_t *run = c->state;
+    uint32_t sum = run->sum;
+    for(int iter = 0; iter < ITERATIONS; iter++) {
+        for(int i = 0; i < ARRAY_SIZE; i += run->stride) {
+            sum += run->array[i];
+        }
+    }
+    run->sum = sum;
+}
+
+BENCH_DEFINE(cache_sequential, "cache", "sequential", memory_access_setup, sequential_run, access_teardown,
+             BENCH_PARAM("mem", MEM_SRAM, MEM_EXTERNAL))
+BENCH_DEFINE(cache_random, "cache", "random", memory_access_setup, random_run, access_teardown,
+             BENCH_PARAM("mem", MEM_SRAM, MEM_EXTERNAL))
+BENCH_DEFINE(cache_stride, "cache", "stride", stride_access_setup, stride_run, access_teardown,
+             BENCH_PARAM("stride", 1, 2, 4, 8, 16))
+
+// measure_* return the median cycles per run; ratios between them are clock-independent
+static uint64_t measure_case(const bench_def_t *def, int32_t value) {
+    bench_result_t result;
+    if(!bench_run_case(def, &value, &result)) {
+        return 0;
+    }
+    return (uint64_t)result.stats.median;
+}
+
+static uint64_t measure_sequential_access(int32_t mem) {
+    return measure_case(&cache_sequential, mem);
+}
+
+static uint64_t measure_random_access(int32_t mem) {
+    return measure_case(&cache_random, mem);
+}
+
+static uint64_t measure_stride_access(int stride) {
+    return measure_case(&cache_stride, stride);
+}
+
+// Silent timing loops for the sweep: cycles for `passes` full passes over `count` elements
+static uint64_t time_sequential_pass(const uint32_t *array, size_t count, int passes, uint32_t *sum_out) {
+    bench_timer_t timer;
+    uint32_t sum = 0;
+    bench_timer_start(&timer);
+
+    for(int pass = 0; pass < passes; pass++) {
+        for(size_t i = 0; i < count; i++) {
+            sum += array[i];
+        }
+    }
+
+    uint64_t cycles = bench_timer_stop(&timer);
+    *sum_out = sum;
+    return cycles;
+}
+
+static uint64_t time_random_pass(const uint32_t *array, size_t count, int passes, uint32_t *sum_out) {
+    bench_timer_t timer;
+    uint32_t sum = 0;
+    bench_timer_start(&timer);
+
+    for(int pass = 0; pass < passes; pass++) {
+        for(size_t i = 0; i < count; i++) {
+            // Same multiplicative hash as measure_random_access
+            size_t index = (i * 2654435761U) % count;
+            sum += array[index];
+        }
+    }
+
+    uint64_t cycles = bench_timer_stop(&timer);
+    *sum_out = sum;
+    return cycles;
+}
+
+typedef struct {
+    size_t bytes;
+    double seq_ns;   // ns per access, sequential
+    double rand_ns;  // ns per access, random
+} sweep_point_t;
+
+static double sweep_ns(const sweep_point_t *point, int use_random) {
+    return use_random ? point->rand_ns : point->seq_ns;
+}
+
+// Report the sizes where ns/access rises SWEEP_KNEE_RATIO above the plateau
+// established by the preceding points. The rise must hold at the next point
+// too, so a single noisy sample is not reported. The plateau resets at each
+// knee so a second tier (e.g. cache -> PSRAM) is detected on its own.
+static void report_knees(const sweep_point_t *points, int count, int use_random, const char *label,
+                         const char *tier_name) {
+    char params[64];
+    int knees = 0;
+    double plateau = sweep_ns(&points[0], use_random);
+
+    for(int k = 1; k < count; k++) {
+        double ns = sweep_ns(&points[k], use_random);
+        if(ns < plateau) {
+            plateau = ns;
+            continue;
+        }
+
+        double threshold = plateau * SWEEP_KNEE_RATIO;
+        int sustained = (k == count - 1) || sweep_ns(&points[k + 1], use_random) >= threshold;
+        if(ns >= threshold && sustained) {
+            printf("  %s knee between %.1f KB and %.1f KB: %.2f -> %.2f ns/access (%.2fx)\n",
+                   label, points[k - 1].bytes / 1024.0, points[k].bytes / 1024.0,
+                   plateau, ns, ns / plateau);
+            snprintf(params, sizeof(params), "tier=%s pattern=%s index=%d",
+                     tier_name, use_random ? "random" : "sequential", knees);
+            bench_report_metric("cache", "sweep_knee", params, "bytes", points[k].bytes, true);
+            plateau = ns;
+            knees++;
+        }
+    }
+
+    if(knees == 0) {
+        printf("  %s: no knee found (flat within %.0f%%)\n", label, (SWEEP_KNEE_RATIO - 1.0) * 100.0);
+    }
+}
+
+// Sweep working-set size for one memory tier (`tier_name` must not contain
+// spaces: it is reported as a metric parameter). Each point gets a freshly
+// allocated buffer so the curve reflects where the data actually lives.
+static void run_working_set_sweep(const char *tier_name, uint32_t caps, size_t min_bytes, size_t max_bytes) {
+    sweep_point_t points[SWEEP_MAX_POINTS];
+    int count = 0;
+
+    printf("\n--- %s working-set sweep ---\n", tier_name);
+    printf("%10s %14s %14s %8s\n", "Size", "Seq ns/acc", "Rand ns/acc", "Passes");
+
+    for(size_t base = min_bytes; base <= max_bytes && count < SWEEP_MAX_POINTS; base *= 2) {
+        size_t sizes[2] = { base, base + base / 2 };
+
+        for(int s = 0; s < 2 && count < SWEEP_MAX_POINTS; s++) {
+            size_t bytes = sizes[s];
+            if(bytes > max_bytes) {
+                break;
+            }
+
+            uint32_t *buffer = heap_caps_malloc(bytes, caps);
+            if(buffer == NULL) {
+                printf("%7.1f KB   allocation failed, %s sweep stops here\n", bytes / 1024.0, tier_name);
+                goto done;
+            }
+
+            size_t elements = bytes / sizeof(uint32_t);
+            for(size_t i = 0; i < elements; i++) {
+                buffer[i] = i * 7 + 13;
+            }
+
+            int passes = SWEEP_TARGET_ACCESSES / elements;
+            if(passes < 1) {
+                passes = 1;
+            }
+
+            uint32_t seq_sum, rand_sum;
+            // One untimed pass so the first timed pass does not pay for cold misses
+            time_sequential_pass(buffer, elements, 1, &seq_sum);
+            uint64_t seq_cycles = time_sequential_pass(buffer, elements, passes, &seq_sum);
+            uint64_t rand_cycles = time_random_pass(buffer, elements, passes, &rand_sum);
+            heap_caps_free(buffer);
+
+            double accesses = (double)elements * passes;
+            points[count].bytes = bytes;
+            points[count].seq_ns = bench_cycles_to_ns(seq_cycles) / accesses;
+            points[count].rand_ns = bench_cycles_to_ns(rand_cycles) / accesses;
+            printf("%7.1f KB %14.2f %14.2f %8d (sum=%lu)\n", bytes / 1024.0,
+                   points[count].seq_ns, points[count].rand_ns, passes,
+                   (unsigned long)(seq_sum + rand_sum));
+
+            char params[48];
+            snprintf(params, sizeof(params), "tier=%s bytes=%u", tier_name, (unsigned)bytes);
+            bench_report_metric("cache", "sweep_sequential", params, "ns/access", points[count].seq_ns, false);
+            bench_report_metric("cache", "sweep_random", params, "ns/access", points[count].rand_ns, false);
+            count++;
+        }
+    }
+
+done:
+    if(count < 2) {
+        printf("  Not enough points for knee detection\n");
+        return;
+    }
+    report_knees(points, count, 0, "Sequential", tier_name);
+    report_knees(points, count, 1, "Random", tier_name);
+}
+
+// Link `count` pointer slots into one random cycle (Sattolo's shuffle), so
+// the hardware sees no stride and the chase touches every slot once per lap.
+static void build_chase_cycle(void **slots, size_t count) {
+    uint32_t state = 0x9E3779B9;  // fixed seed: identical layout on every run
+
+    for(size_t i = 0; i < count; i++) {
+        slots[i] = &slots[i];
+    }
+    for(size_t i = count - 1; i > 0; i--) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        size_t j = state % i;  // j < i, never i itself: yields a single cycle
+        void *tmp = slots[i];
+        slots[i] = slots[j];
+        slots[j] = tmp;
+    }
+}
+
+// Chase regions ("region" parameter)
+enum { CHASE_SRAM, CHASE_PSRAM, CHASE_FLASH };
+
+typedef struct {
+    const void *const *start;
+    void **slots;  // heap buffer, NULL for the flash table
+} chase_run_t;
+
+static bool chase_setup(bench_case_t *c) {
+    static const char *const names[] = { "Internal SRAM", "PSRAM", "Flash rodata" };
+    if(c->values[0] < CHASE_SRAM || c->values[0] > CHASE_FLASH) {
+        return false;
+    }
+
+    chase_run_t *run = calloc(1, sizeof(chase_run_t));
+    if(run == NULL) {
+        return false;
+    }
+
+    int32_t region = c->values[0];
+    c->memory = names[region];
+    if(region == CHASE_FLASH) {
+        run->start = flash_chase_table;
+    } else {
+        size_t bytes = region == CHASE_SRAM ? CHASE_SRAM_BYTES : CHASE_PSRAM_BYTES;
+        uint32_t caps = (region == CHASE_SRAM ? MALLOC_CAP_INTERNAL : MALLOC_CAP_SPIRAM) | MALLOC_CAP_8BIT;
+        run->slots = heap_caps_malloc(bytes, caps);
+        if(run->slots == NULL) {
+            free(run);
+            return false;
+        }
+        build_chase_cycle(run->slots, bytes / sizeof(void *));
+        run->start = (const void *const *)run->slots;
+    }
+
+    c->state = run;
+    c->elements = CHASE_LOADS;  // cycles/element is the per-load latency
+    return true;
+}
+
+// Follow the chain for CHASE_LOADS dependent loads. No arithmetic sits between
+// loads, so the time per load is the load-to-use latency of the region.
+static void chase_run(bench_case_t *c) {
+    chase_run_t *run = c->state;
+    const void *const *p = run->start;
+
+    for(uint32_t i = 0; i < CHASE_LOADS; i += 8) {
+        p = (const void *const *)*p;
+        p = (const void *const *)*p;
+        p = (const void *const *)*p;
+        p = (const void *const *)*p;
+        p = (const void *const *)*p;
+        p = (const void *const *)*p;
+        p = (const void *const *)*p;
+        p = (const void *const *)*p;
+    }
+
+    run->start = p;  // continue from here next run; also keeps the chain observable
+}
+
+static void chase_teardown(bench_case_t *c) {
+    chase_run_t *run = c->state;
+    if(run->slots) {
+        heap_caps_free(run->slots);
+    }
+    free(run);
+}
+
+BENCH_DEFINE(cache_chase, "cache", "chase", chase_setup, chase_run, chase_teardown,
+             BENCH_PARAM("region", CHASE_SRAM, CHASE_PSRAM, CHASE_FLASH))
+
+// Each region's chase, followed by its per-load latency in cycles and ns
+static void report_chase(void) {
+    for(int32_t region = CHASE_SRAM; region <= CHASE_FLASH; region++) {
+        bench_result_t result;
+        if(!bench_run_case(&cache_chase, &region, &result)) {
+            continue;
+        }
+        printf("    latency: %.2f cycles, %.1f ns per load\n", result.stats.median / CHASE_LOADS,
+               bench_cycles_to_ns((uint64_t)result.stats.median) / CHASE_LOADS);
+    }
+}
+
+// Bandwidth kernels. Integer arithmetic stands in for STREAM's doubles: the
+// ESP32 FPU is single precision only and would make scale/triad FPU-bound.
+static void bw_copy(uint32_t *a, uint32_t *b, uint32_t *c, size_t n) {
+    for(size_t i = 0; i < n; i++) c[i] = a[i];
+}
+
+static void bw_scale(uint32_t *a, uint32_t *b, uint32_t *c, size_t n) {
+    for(size_t i = 0; i < n; i++) b[i] = BW_SCALAR * c[i];
+}
+
+static void bw_add(uint32_t *a, uint32_t *b, uint32_t *c, size_t n) {
+    for(size_t i = 0; i < n; i++) c[i] = a[i] + b[i];
+}
+
+static void bw_triad(uint32_t *a, uint32_t *b, uint32_t *c, size_t n) {
+    for(size_t i = 0; i < n; i++) a[i] = b[i] + BW_SCALAR * c[i];
+}
+
+static void bw_read(uint32_t *a, uint32_t *b, uint32_t *c, size_t n) {
+    uint32_t sum = 0;
+    for(size_t i = 0; i < n; i++) sum += a[i];
+    result_sink = sum;
+}
+
+static void bw_write(uint32_t *a, uint32_t *b, uint32_t *c, size_t n) {
+    for(size_t i = 0; i < n; i++) a[i] = BW_SCALAR;
+}
+
+static void bw_rmw(uint32_t *a, uint32_t *b, uint32_t *c, size_t n) {
+    for(size_t i = 0; i < n; i++) a[i] += BW_SCALAR;
+}
+
+typedef struct {
+    const char *name;
+    int words_moved;  // words read + written per element, STREAM counting (no write-allocate)
+    void (*fn)(uint32_t *a, uint32_t *b, uint32_t *c, size_t n);
+} bw_kernel_t;
+
+static const bw_kernel_t bw_kernels[] = {
+    { "Copy", 2, bw_copy },
+    { "Scale", 2, bw_scale },
+    { "Add", 3, bw_add },
+    { "Triad", 3, bw_triad },
+    { "Read", 1, bw_read },
+    { "Write", 1, bw_write },
+    { "RMW", 2, bw_rmw },
+};
+
+// Bandwidth regions ("region" parameter); "kernel" indexes bw_kernels
+enum { BW_SRAM, BW_PSRAM, BW_DMA, BW_RTC_FAST };
+
+typedef struct {
+    const bw_kernel_t *kernel;
+    uint32_t *base;
+    bool owned;  // heap buffer to free in teardown
+    uint32_t *a, *b, *c;
+    size_t n;
+    int calls;
+} bw_run_t;
+
+static bool bandwidth_setup(bench_case_t *c) {
+    static const char *const names[] = { "SRAM", "PSRAM", "DMA-capable", "RTC fast" };
+    if(c->values[0] < BW_SRAM || c->values[0] > BW_RTC_FAST ||
+       c->values[1] < 0 || c->values[1] >= (int32_t)(sizeof(bw_kernels) / sizeof(bw_kernels[0]))) {
+        return false;
+    }
+
+    bw_run_t *run = calloc(1, sizeof(bw_run_t));
+    if(run == NULL) {
+        return false;
+    }
+
+    int32_t region = c->values[0];
+    size_t words = 0;
+    c->memory = names[region];
+    switch(region) {
+        case BW_SRAM:
+            run->base = sram_array;
+            words = ARRAY_SIZE;
+            break;
+        case BW_PSRAM:
+            run->base = heap_caps_malloc(BW_PSRAM_BYTES, MALLOC_CAP_SPIRAM);
+            words = BW_PSRAM_BYTES / sizeof(uint32_t);
+            run->owned = true;
+            break;
+        case BW_DMA:
+            run->base = heap_caps_malloc(BW_DMA_BYTES, MALLOC_CAP_DMA);
+            words = BW_DMA_BYTES / sizeof(uint32_t);
+            run->owned = true;
+            break;
+        case BW_RTC_FAST:
+            run->base = rtc_fast_array;
+            words = BW_RTC_WORDS;
+            break;
+    }
+    if(run->base == NULL) {
+        free(run);
+        return false;
+    }
+
+    run->kernel = &bw_kernels[c->values[1]];
+    run->n = words / 3;
+    run->a = run->base;
+    run->b = run->base + run->n;
+    run->c = run->base + 2 * run->n;
+    for(size_t i = 0; i < run->n; i++) {
+        run->a[i] = 1;
+        run->b[i] = 2;
+        run->c[i] = 0;
+    }
+
+    size_t bytes_per_call = run->n * run->kernel->words_moved * sizeof(uint32_t);
+    run->calls = BW_TARGET_BYTES / bytes_per_call;
+    if(run->calls < 1) {
+        run->calls = 1;
+    }
+
+    c->state = run;
+    c->elements = (uint64_t)run->n * run->calls;
+    c->bytes = (uint64_t)bytes_per_call * run->calls;
+    c->config.min_runs = BW_REPEATS;
+    return true;
+}
+
+static void bandwidth_run(bench_case_t *c) {
+    bw_run_t *run = c->state;
+    for(int call = 0; call < run->calls; call++) {
+        run->kernel->fn(run->a, run->b, run->c, run->n);
+    }
+}
+
+static void bandwidth_teardown(bench_case_t *c) {
+    bw_run_t *run = c->state;
+    if(run->owned) {
+        heap_caps_free(run->base);
+    } else if(run->base == sram_array) {
+        // Restore the pattern the access benchmarks expect in sram_array
+        for(int i = 0; i < ARRAY_SIZE; i++) {
+            sram_array[i] = i * 7 + 13;
+        }
+    }
+    free(run);
+}
+
+// kernel: 0 Copy, 1 Scale, 2 Add, 3 Triad, 4 Read, 5 Write, 6 RMW
+BENCH_DEFINE(cache_bandwidth, "cache", "bandwidth", bandwidth_setup, bandwidth_run, bandwidth_teardown,
+             BENCH_PARAM("region", BW_SRAM, BW_PSRAM, BW_DMA, BW_RTC_FAST),
+             BENCH_PARAM("kernel", 0, 1, 2, 3, 4, 5, 6))
+
+// Two-core scaling: the access and bandwidth kernels above, with the array
+// split between the cores by parallel_for(). Each core gets one contiguous
+// part; cores=1 runs the same chunk function over the whole array on the
+// calling task, so the ratio of the two is the speedup from the second core.
+// Loops bound by a shared resource (the PSRAM bus, the cache) gain little.
+// mem=External runs over a PSRAM buffer of BW_PSRAM_BYTES, twice the cache
+// like cache/bandwidth's, and is skipped without PSRAM.
+#define SCALING_GRAIN (PERCORE_CACHE_LINE / sizeof(uint32_t))  // chunk edges on cache-line boundaries
+
+// "kernel" parameter
+enum { SCALE_SEQUENTIAL, SCALE_RANDOM, SCALE_COPY, SCALE_TRIAD, SCALE_WRITE, SCALE_KERNELS };
+static const char *const scaling_names[] = { "Sequential", "Random", "Copy", "Triad", "Write" };
+
+static parallel_pool_t *scaling_pool;
+
+typedef struct {
+    PERCORE_PADDED(uint32_t) sums[PARALLEL_MAX_CORES];
+    const bw_kernel_t *kernel;  // NULL for the access kernels
+    uint32_t *base;
+    bool owned;                 // PSRAM buffer to free in teardown
+    uint32_t *a, *b, *c;
+    uint32_t count;             // elements split between the cores
+    int iterations;             // access kernels: passes per run
+    int calls;
+    uint32_t cores;
+    parallel_fn_t fn;
+} scaling_run_t;
+
+static void scaling_sequential(void *arg, uint32_t begin, uint32_t end, uint32_t core) {
+    scaling_run_t *run = arg;
+    const uint32_t *array = run->base;
+    uint32_t sum = 0;
+    for(int iter = 0; iter < run->iterations; iter++) {
+        for(uint32_t i = begin; i < end; i++) {
+            sum += array[i];
+        }
+    }
+    run->sums[core].value += sum;
+}
+
+static void scaling_random(void *arg, uint32_t begin, uint32_t end, uint32_t core) {
+    scaling_run_t *run = arg;
+    const uint32_t *array = run->base;
+    uint32_t sum = 0;
+    for(int iter = 0; iter < run->iterations; iter++) {
+        for(uint32_t i = begin; i < end; i++) {
+            // Same index sequence as random_run, so the whole array is touched
+            sum += array[(i * 2654435761U) % run->count];
+        }
+    }
+    run->sums[core].value += sum;
+}
+
+static void scaling_bandwidth(void *arg, uint32_t begin, uint32_t end, uint32_t core) {
+    scaling_run_t *run = arg;
+    for(int call = 0; call < run->calls; call++) {
+        run->kernel->fn(run->a + begin, run->b + begin, run->c + begin, end - begin);
+    }
+}
+
+static bool scaling_setup(bench_case_t *c) {
+    static const int bw_index[] = { [SCALE_COPY] = 0, [SCALE_TRIAD] = 3, [SCALE_WRITE] = 5 };
+    int32_t kernel = c->values[0];
+    int32_t mem = c->values[1];
+    if(kernel < 0 || kernel >= SCALE_KERNELS || (mem != MEM_SRAM && mem != MEM_EXTERNAL) ||
+       c->values[2] < 1 || c->values[2] > PARALLEL_MAX_CORES) {
+        return false;
+    }
+    if(scaling_pool == NULL) {
+        // Same priority as the caller: the pool only ever runs on its behalf
+        scaling_pool = parallel_pool_create(uxTaskPriorityGet(NULL));
+        if(scaling_pool == NULL) {
+            return false;
+        }
+    }
+
+    scaling_run_t *run = heap_caps_aligned_calloc(PERCORE_CACHE_LINE, 1, sizeof(scaling_run_t),
+                                                  MALLOC_CAP_INTERNAL);
+    if(run == NULL) {
+        return false;
+    }
+    uint32_t words = ARRAY_SIZE;
+    run->base = sram_array;
+    if(mem == MEM_EXTERNAL) {
+        words = BW_PSRAM_BYTES / sizeof(uint32_t);
+        run->base = heap_caps_malloc(BW_PSRAM_BYTES, MALLOC_CAP_SPIRAM);
+        if(run->base == NULL) {
+            heap_caps_free(run);
+            return false;
+        }
+        run->owned = true;
+        for(uint32_t i = 0; i < words; i++) {
+            run->base[i] = i * 7 + 13;
+        }
+    }
+    run->cores = c->values[2];
+    if(kernel == SCALE_SEQUENTIAL || kernel == SCALE_RANDOM) {
+        // As many accesses per run as ITERATIONS passes over the SRAM array
+        run->fn = kernel == SCALE_SEQUENTIAL ? scaling_sequential : scaling_random;
+        run->count = words;
+        run->iterations = (ITERATIONS * ARRAY_SIZE + words - 1) / words;
+        c->elements = (uint64_t)run->iterations * words;
+    } else {
+        // Same a/b/c split and traffic per run as cache/bandwidth
+        run->fn = scaling_bandwidth;
+        run->kernel = &bw_kernels[bw_index[kernel]];
+        run->count = words / 3;
+        run->a = run->base;
+        run->b = run->base + run->count;
+        run->c = run->base + 2 * run->count;
+        size_t bytes_per_call = run->count * run->kernel->words_moved * sizeof(uint32_t);
+        run->calls = BW_TARGET_BYTES / bytes_per_call;
+        c->elements = (uint64_t)run->count * run->calls;
+        c->bytes = (uint64_t)bytes_per_call * run->calls;
+    }
+
+    c->state = run;
+    c->memory = memory_names[mem];
+    c->config.min_runs = TEST_RUNS;
+    return true;
+}
+
+static void scaling_run(bench_case_t *c) {
+    scaling_run_t *run = c->state;
+    parallel_for(scaling_pool, run->count, SCALING_GRAIN, run->cores, run->fn, run);
+}
+
+static void scaling_teardown(bench_case_t *c) {
+    scaling_run_t *run = c->state;
+    uint32_t sum = 0;
+    for(int core = 0; core < PARALLEL_MAX_CORES; core++) {
+        sum += run->sums[core].value;
+    }
+    result_sink = sum;
+    if(run->owned) {
+        heap_caps_free(run->base);
+    } else if(run->kernel) {
+        // The bandwidth kernels overwrite the array; restore the access pattern
+        for(int i = 0; i < ARRAY_SIZE; i++) {
+            run->base[i] = i * 7 + 13;
+        }
+    }
+    heap_caps_free(run);
+}
+
+// kernel: 0 Sequential, 1 Random, 2 Copy, 3 Triad, 4 Write
+BENCH_DEFINE(cache_scaling, "cache", "scaling", scaling_setup, scaling_run, scaling_teardown,
+             BENCH_PARAM("kernel", SCALE_SEQUENTIAL, SCALE_RANDOM, SCALE_COPY, SCALE_TRIAD, SCALE_WRITE),
+             BENCH_PARAM("mem", MEM_SRAM, MEM_EXTERNAL),
+             BENCH_PARAM("cores", 1, 2))
+
+// Speedup of each scaling kernel from the second core, as a metric per kernel
+static void report_scaling(int32_t mem) {
+    printf("%-12s %14s %14s %9s\n", "Kernel", "1-core cyc", "2-core cyc", "Speedup");
+    for(int32_t kernel = 0; kernel < SCALE_KERNELS; kernel++) {
+        bench_result_t one, two;
+        int32_t values[3] = { kernel, mem, 1 };
+        if(!bench_run_case(&cache_scaling, values, &one)) {
+            continue;
+        }
+        values[2] = PARALLEL_MAX_CORES;
+        if(!bench_run_case(&cache_scaling, values, &two) || two.stats.median <= 0) {
+            continue;
+        }
+
+        double speedup = one.stats.median / two.stats.median;
+        printf("%-12s %14.0f %14.0f %8.2fx\n", scaling_names[kernel], one.stats.median,
+               two.stats.median, speedup);
+        char params[48];
+        snprintf(params, sizeof(params), "kernel=%s mem=%s", scaling_names[kernel], memory_names[mem]);
+        bench_report_metric("cache", "scaling_speedup", params, "x", speedup, true);
+    }
+}
+
+static void initialize_arrays() {
+    printf("Initializing test arrays...\n");
+    
+    // Initialize SRAM array
+    for(int i = 0; i < ARRAY_SIZE; i++) {
+        sram_array[i] = i * 7 + 13;  // Some pattern
+    }
+    
+    // Try to allocate PSRAM array (if available)
+    psram_array = heap_caps_malloc(ARRAY_SIZE * sizeof(uint32_t), MALLOC_CAP_SPIRAM);
+    if(psram_array) {
+        printf("PSRAM array allocated successfully\n");
+        for(int i = 0; i < ARRAY_SIZE; i++) {
+            psram_array[i] = i * 7 + 13;
+        }
+    } else {
+        printf("PSRAM not available, using internal memory\n");
+        psram_array = heap_caps_malloc(ARRAY_SIZE * sizeof(uint32_t), MALLOC_CAP_INTERNAL);
+        if(psram_array) {
+            for(int i = 0; i < ARRAY_SIZE; i++) {
+                psram_array[i] = i * 7 + 13;
+            }
+        }
+    }
+}
+
+void cache_suite_sweep(size_t min_bytes, size_t max_bytes) {
+    if(min_bytes < sizeof(uint32_t)) {
+        min_bytes = sizeof(uint32_t);
+    }
+    run_working_set_sweep("SRAM", MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, min_bytes, max_bytes);
+    if(heap_caps_get_free_size(MALLOC_CAP_SPIRAM) > 0) {
+        run_working_set_sweep("PSRAM", MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, min_bytes, max_bytes);
+    } else {
+        printf("\nPSRAM not available (CONFIG_SPIRAM disabled?), skipping PSRAM sweep\n");
+    }
+}
+
+void cache_suite_init(void) {
+    if(psram_array == NULL) {
+        initialize_arrays();
+    }
+}
+
+void cache_suite_deinit(void) {
+    parallel_pool_delete(scaling_pool);
+    scaling_pool = NULL;
+    if(psram_array) {
+        free(psram_array);
+        psram_array = NULL;
+    }
+}
+
+void cache_suite_run_all(void) {
+    printf("Array size: %d elements (%d KB)\n", ARRAY_SIZE, (ARRAY_SIZE * 4) / 1024);
+    printf("Iterations per test: %d\n", ITERATIONS);
+    printf("Test runs: %d minimum (warm-up, then adaptive until CI95 within 1%%)\n", TEST_RUNS);
+    printf("Running on core %d\n\n", xPortGetCoreID());
+    
+    cache_suite_init();
+    
+    // Test 1: Sequential vs Random Access (SRAM)
+    printf("\n=== Test 1: Sequential vs Random Access (Internal SRAM) ===\n");
+    uint64_t sram_sequential = measure_sequential_access(MEM_SRAM);
+    uint64_t sram_random = measure_random_access(MEM_SRAM);
+    
+    double sram_ratio = (double)sram_random / sram_sequential;
+    printf("SRAM Performance Ratio (Random/Sequential): %.2fx\n", sram_ratio);
+    
+    // Test 2: External Memory (if available)
+    if(psram_array) {
+        printf("\n=== Test 2: External Memory Access ===\n");
+        uint64_t psram_sequential = measure_sequential_access(MEM_EXTERNAL);
+        uint64_t psram_random = measure_random_access(MEM_EXTERNAL);
+        
+        double psram_ratio = (double)psram_random / psram_sequential;
+        printf("External Memory Performance Ratio: %.2fx\n", psram_ratio);
+        
+        printf("\nMemory Type Comparison (Sequential Access):\n");
+        double memory_ratio = (double)psram_sequential / sram_sequential;
+        printf("External/Internal Speed Ratio: %.2fx\n", memory_ratio);
+    }
+    
+    // Test 3: Different Stride Patterns
+    printf("\n=== Test 3: Stride Access Patterns ===\n");
+    uint64_t stride1 = measure_stride_access(1);
+    uint64_t stride2 = measure_stride_access(2);
+    uint64_t stride4 = measure_stride_access(4);
+    uint64_t stride8 = measure_stride_access(8);
+    uint64_t stride16 = measure_stride_access(16);
+    
+    printf("\nStride Analysis:\n");
+    printf("Stride 2/1 ratio: %.2fx\n", (double)stride2/stride1);
+    printf("Stride 4/1 ratio: %.2fx\n", (double)stride4/stride1);
+    printf("Stride 8/1 ratio: %.2fx\n", (double)stride8/stride1);
+    printf("Stride 16/1 ratio: %.2fx\n", (double)stride16/stride1);
+    
+    // Test 4: Dependent-load latency (pointer chasing)
+    printf("\n=== Test 4: Pointer-Chasing Load Latency ===\n");
+    printf("%d dependent loads per run; cycles/element is the per-load latency\n", CHASE_LOADS);
+    report_chase();
+
+    // Test 5: Read/write bandwidth per memory region
+    printf("\n=== Test 5: STREAM-Style Bandwidth ===\n");
+    printf("kernel: 0 Copy, 1 Scale, 2 Add, 3 Triad, 4 Read, 5 Write, 6 RMW\n");
+    bench_run(&cache_bandwidth);
+
+    // Test 6: Which loops gain from the second core
+    printf("\n=== Test 6: Two-Core Scaling (parallel_for) ===\n");
+    report_scaling(MEM_SRAM);
+    if(heap_caps_get_free_size(MALLOC_CAP_SPIRAM) > 0) {
+        printf("\nExternal memory:\n");
+        report_scaling(MEM_EXTERNAL);
+    }
+
+#if ENABLE_WORKING_SET_SWEEP
+    // Test 7: Working-set sweep to locate cache and memory-tier knees
+    printf("\n=== Test 7: Working-Set Sweep (%d KB .. %d KB) ===\n",
+           CACHE_SWEEP_DEFAULT_MIN / 1024, CACHE_SWEEP_DEFAULT_MAX / 1024);
+    cache_suite_sweep(CACHE_SWEEP_DEFAULT_MIN, CACHE_SWEEP_DEFAULT_MAX);
+#endif
+
+    cache_suite_deinit();
+}
\ No newline at end of file
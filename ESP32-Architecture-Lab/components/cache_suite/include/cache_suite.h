@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+
+// Cache and memory-hierarchy benchmarks (group "cache"). The sequential,
+// random, stride, chase, bandwidth and two-core scaling benchmarks are
+// registered with the bench framework and can also be run individually by
+// name.
+
+// Default working-set sweep range: 1 KB .. 4 MB
+#define CACHE_SWEEP_DEFAULT_MIN (1 * 1024)
+#define CACHE_SWEEP_DEFAULT_MAX (4 * 1024 * 1024)
+
+// Allocate and fill the test arrays; called by cache_suite_run_all()
+void cache_suite_init(void);
+void cache_suite_deinit(void);
+
+// Run Tests 1-7 with the default parameters
+void cache_suite_run_all(void);
+
+// Working-set sweep over internal SRAM, then PSRAM when present
+void cache_suite_sweep(size_t min_bytes, size_t max_bytes);
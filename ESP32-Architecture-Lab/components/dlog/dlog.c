@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <esp_cpu.h>
+#include <esp_timer.h>
+#include "spsc_ring.h"
+#include "dlog.h"
+
+#define DLOG_FLUSH_PERIOD_MS 10
+#define DLOG_SPEC_MAX 16
+
+typedef struct {
+    const char *format;
+    uint32_t nargs;
+    int64_t timestamp;  // esp_timer: comparable between the cores, unlike CCOUNT
+    uint64_t args[DLOG_MAX_ARGS];
+} dlog_record_t;
+
+// One ring per core. The producer side is every task (and ISR) on that core;
+// masking interrupts around the push makes them a single producer. The
+// consumer side is whoever holds flush_mutex.
+static spsc_ring_t rings[portNUM_PROCESSORS];
+static dlog_record_t ring_storage[portNUM_PROCESSORS][DLOG_RING_RECORDS];
+static atomic_uint dropped;
+static StaticSemaphore_t flush_mutex_storage;
+static SemaphoreHandle_t flush_mutex;
+static TaskHandle_t flush_task_handle;
+
+static void __attribute__((constructor)) dlog_init(void) {
+    for(int core = 0; core < portNUM_PROCESSORS; core++) {
+        spsc_ring_init(&rings[core], ring_storage[core], sizeof(dlog_record_t), DLOG_RING_RECORDS);
+    }
+    flush_mutex = xSemaphoreCreateMutexStatic(&flush_mutex_storage);
+}
+
+void dlog_write(const char *format, uint32_t nargs, const uint64_t *args) {
+    dlog_record_t record;
+    record.format = format;
+    record.nargs = nargs < DLOG_MAX_ARGS ? nargs : DLOG_MAX_ARGS;
+    memcpy(record.args, args, record.nargs * sizeof(uint64_t));
+
+    // With interrupts masked the task cannot be preempted or migrate, so the
+    // core id stays valid and records of one core are in timestamp order
+    UBaseType_t state = portSET_INTERRUPT_MASK_FROM_ISR();
+    record.timestamp = esp_timer_get_time();
+    bool stored = spsc_ring_push(&rings[esp_cpu_get_core_id()], &record);
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(state);
+
+    if(!stored) {
+        atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+    }
+}
+
+uint32_t dlog_dropped(void) {
+    return atomic_load_explicit(&dropped, memory_order_relaxed);
+}
+
+// printf one record, one conversion at a time: the arguments were stored as
+// 64-bit words, so each conversion is re-typed from its length modifier
+static void print_record(const dlog_record_t *record) {
+    const char *p = record->format;
+    uint32_t arg = 0;
+    char spec[DLOG_SPEC_MAX];
+
+    while(*p) {
+        if(*p != '%') {
+            const char *text = p;
+            while(*p && *p != '%') {
+                p++;
+            }
+            fwrite(text, 1, p - text, stdout);
+            continue;
+        }
+        if(p[1] == '%') {
+            putchar('%');
+            p += 2;
+            continue;
+        }
+
+        size_t len = 0;
+        int longs = 0;
+        while(*p && len < sizeof(spec) - 2 && (len == 0 || strchr("diouxXeEfgGcsp", *p) == NULL)) {
+            longs += (*p == 'l' || *p == 'z' || *p == 'j');
+            spec[len++] = *p++;
+        }
+        if(*p == '\0') {
+            break;
+        }
+        char conversion = *p++;
+        spec[len++] = conversion;
+        spec[len] = '\0';
+
+        uint64_t value = arg < record->nargs ? record->args[arg++] : 0;
+        union {
+            uint64_t u;
+            double d;
+        } bits = { .u = value };
+
+        switch(conversion) {
+            case 'e': case 'E': case 'f': case 'g': case 'G':
+                printf(spec, bits.d);
+                break;
+            case 's':
+                printf(spec, (const char *)(uintptr_t)value);
+                break;
+            case 'p':
+                printf(spec, (void *)(uintptr_t)value);
+                break;
+            default:
+                if(longs >= 2) {
+                    printf(spec, (unsigned long long)value);
+                } else if(longs == 1) {
+                    printf(spec, (unsigned long)value);
+                } else {
+                    printf(spec, (unsigned int)value);
+                }
+                break;
+        }
+    }
+}
+
+void dlog_flush(void) {
+    dlog_record_t pending[portNUM_PROCESSORS];
+    bool have[portNUM_PROCESSORS] = { false };
+
+    xSemaphoreTake(flush_mutex, portMAX_DELAY);
+    // Two-way merge on the timestamps, one record of lookahead per core
+    while(true) {
+        int oldest = -1;
+        for(int core = 0; core < portNUM_PROCESSORS; core++) {
+            if(!have[core]) {
+                have[core] = spsc_ring_pop(&rings[core], &pending[core]);
+            }
+            if(have[core] && (oldest < 0 || pending[core].timestamp < pending[oldest].timestamp)) {
+                oldest = core;
+            }
+        }
+        if(oldest < 0) {
+            break;
+        }
+        print_record(&pending[oldest]);
+        have[oldest] = false;
+    }
+    xSemaphoreGive(flush_mutex);
+}
+
+static void flush_task(void *parameter) {
+    while(true) {
+        dlog_flush();
+        vTaskDelay(pdMS_TO_TICKS(DLOG_FLUSH_PERIOD_MS));
+    }
+}
+
+bool dlog_start(uint32_t priority) {
+    if(flush_task_handle == NULL &&
+       xTaskCreate(flush_task, "dlog", 3072, NULL, priority, &flush_task_handle) != pdPASS) {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Deferred binary logging.
+//
+// dlog() does not format anything. It stores the format string's address
+// (string literals live in flash rodata), an esp_timer timestamp and up to
+// DLOG_MAX_ARGS raw arguments in a ring belonging to the calling core; a
+// low-priority task (dlog_start()) or an explicit dlog_flush() formats the
+// records later, oldest first across both cores. The hot path costs a
+// record copy with interrupts masked on the local core for a few dozen
+// cycles: no lock shared with the other core, no UART wait, no vprintf.
+//
+// Arguments are captured by value as 64-bit words: integers, floats/doubles
+// and pointers. A `%s` argument must stay valid until it is printed, so pass
+// only static strings; copy anything else into a number first. When a core's
+// ring is full the record is dropped and counted (dlog_dropped()).
+
+#define DLOG_MAX_ARGS 6
+#define DLOG_RING_RECORDS 64  // per core, power of two
+
+void dlog_write(const char *format, uint32_t nargs, const uint64_t *args);
+
+// Start the formatting task (once; later calls do nothing)
+bool dlog_start(uint32_t priority);
+
+// Format and print everything recorded so far
+void dlog_flush(void);
+
+// Records lost to a full ring since boot
+uint32_t dlog_dropped(void);
+
+static inline uint64_t dlog_arg_u64(uint64_t value) {
+    return value;
+}
+
+static inline uint64_t dlog_arg_f64(double value) {
+    union {
+        double d;
+        uint64_t u;
+    } bits = { .d = value };
+    return bits.u;
+}
+
+static inline uint64_t dlog_arg_ptr(const void *value) {
+    return (uintptr_t)value;
+}
+
+#define DLOG_ARG(x) _Generic((x),                                               \
+    float: dlog_arg_f64, double: dlog_arg_f64,                                  \
+    char *: dlog_arg_ptr, const char *: dlog_arg_ptr,                           \
+    void *: dlog_arg_ptr, const void *: dlog_arg_ptr,                           \
+    default: dlog_arg_u64)(x)
+
+#define DLOG_COUNT(...) DLOG_COUNT_(_, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_COUNT_(_, a, b, c, d, e, f, n, ...) n
+#define DLOG_ARGS_0()
+#define DLOG_ARGS_1(a) DLOG_ARG(a)
+#define DLOG_ARGS_2(a, b) DLOG_ARG(a), DLOG_ARG(b)
+#define DLOG_ARGS_3(a, b, c) DLOG_ARGS_2(a, b), DLOG_ARG(c)
+#define DLOG_ARGS_4(a, b, c, d) DLOG_ARGS_3(a, b, c), DLOG_ARG(d)
+#define DLOG_ARGS_5(a, b, c, d, e) DLOG_ARGS_4(a, b, c, d), DLOG_ARG(e)
+#define DLOG_ARGS_6(a, b, c, d, e, f) DLOG_ARGS_5(a, b, c, d, e), DLOG_ARG(f)
+#define DLOG_CAT(a, b) DLOG_CAT_(a, b)
+#define DLOG_CAT_(a, b) a##b
+
+// dlog("Core %d: sent %lu\n", core, id) -- printf syntax, at most DLOG_MAX_ARGS arguments
+#define dlog(format, ...)                                                       \
+    dlog_write((format), DLOG_COUNT(__VA_ARGS__),                               \
+               (const uint64_t[DLOG_MAX_ARGS]){ DLOG_CAT(DLOG_ARGS_, DLOG_COUNT(__VA_ARGS__))(__VA_ARGS__) })
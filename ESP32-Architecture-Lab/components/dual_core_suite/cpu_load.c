@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "dual_core_private.h"
+
+// Load is measured from the idle tasks: whatever share of the elapsed
+// run-time counter (esp_timer microseconds) a core's idle task did not get,
+// something else ran on that core. One uxTaskGetSystemState() per sample
+// walks the task lists with the scheduler suspended, a few tens of
+// microseconds for this firmware's dozen or so tasks. Counters are 32-bit
+// and only ever subtracted, so their wrap every ~71 minutes is harmless.
+
+#if configGENERATE_RUN_TIME_STATS == 1 && configUSE_TRACE_FACILITY == 1
+
+static TaskStatus_t statuses[CPU_LOAD_MAX_TASKS];  // too big for a monitor's stack
+
+// Run time of `handle` at the baseline; 0 for a task created since
+static uint32_t baseline_runtime(const cpu_load_t *load, void *handle) {
+    for(uint32_t i = 0; i < load->count; i++) {
+        if(load->tasks[i].handle == handle) {
+            return load->tasks[i].runtime;
+        }
+    }
+    return 0;
+}
+
+static UBaseType_t sample(uint32_t *total) {
+    configRUN_TIME_COUNTER_TYPE now;
+    UBaseType_t count = uxTaskGetSystemState(statuses, CPU_LOAD_MAX_TASKS, &now);
+    *total = (uint32_t)now;
+    return count;  // 0 if there are more tasks than CPU_LOAD_MAX_TASKS
+}
+
+static void save_baseline(cpu_load_t *load, UBaseType_t count, uint32_t total) {
+    load->total = total;
+    load->count = count;
+    for(UBaseType_t i = 0; i < count; i++) {
+        load->tasks[i].handle = statuses[i].xHandle;
+        load->tasks[i].runtime = (uint32_t)statuses[i].ulRunTimeCounter;
+    }
+}
+
+void cpu_load_start(cpu_load_t *load) {
+    uint32_t total;
+    UBaseType_t count = sample(&total);
+    save_baseline(load, count, total);
+}
+
+bool cpu_load_update(cpu_load_t *load, float busy[2], bool print) {
+    uint32_t total;
+    UBaseType_t count = sample(&total);
+    uint32_t elapsed = total - load->total;
+    if(count == 0 || load->count == 0 || elapsed == 0) {
+        save_baseline(load, count, total);
+        return false;
+    }
+
+    for(int core = 0; core < 2; core++) {
+        TaskHandle_t idle = xTaskGetIdleTaskHandleForCore(core);
+        uint32_t idle_time = 0;
+        for(UBaseType_t i = 0; i < count; i++) {
+            if(statuses[i].xHandle == idle) {
+                idle_time = (uint32_t)statuses[i].ulRunTimeCounter - baseline_runtime(load, idle);
+            }
+        }
+        busy[core] = idle_time >= elapsed ? 0.0f : 100.0f * (elapsed - idle_time) / elapsed;
+    }
+
+    if(print) {
+        // CPU share is of one core: a task pinned to a fully busy core shows 100%
+        printf("CPU load: core 0 %.1f%%, core 1 %.1f%%\n", busy[0], busy[1]);
+        printf("%-16s %6s %12s\n", "Task", "CPU%", "Stack free");
+        for(UBaseType_t i = 0; i < count; i++) {
+            uint32_t runtime = (uint32_t)statuses[i].ulRunTimeCounter - baseline_runtime(load, statuses[i].xHandle);
+            printf("%-16s %5.1f%% %6lu bytes\n", statuses[i].pcTaskName, 100.0 * runtime / elapsed,
+                   (unsigned long)statuses[i].usStackHighWaterMark);
+        }
+    }
+
+    save_baseline(load, count, total);
+    return true;
+}
+
+#else
+
+void cpu_load_start(cpu_load_t *load) {
+    load->count = 0;
+}
+
+bool cpu_load_update(cpu_load_t *load, float busy[2], bool print) {
+    return false;
+}
+
+#endif
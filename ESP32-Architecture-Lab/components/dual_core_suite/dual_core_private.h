@@ -0,0 +1,129 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "dual_core_suite.h"
+
+// Shared between the workload (dual_core_suite.c) and the registered
+// benchmarks of this component
+
+// Message structure for inter-core communication
+typedef struct {
+    uint32_t sender_core;
+    uint32_t message_id;
+    uint64_t timestamp;  // esp_timer, not CCOUNT: the cycle counters of the two cores are independent
+    char data[32];
+} core_message_t;
+
+// Depth of core_queue and of the SPSC ring that replaces it; a power of two
+// so both transports can use the same value
+#define CORE_QUEUE_LENGTH 16
+
+// Helper tasks of the benchmarks run on core 1 while the measuring task
+// stays on core 0, where its cycle counter lives
+#define DUAL_CORE_HELPER_CORE 1
+#define DUAL_CORE_HELPER_PRIORITY 5
+
+// A benchmark's helper task (helper_task.c). The run state holds a zeroed
+// dual_core_helper_t; the task polls `stop` and ends in
+// dual_core_helper_exit(). Joining a helper that was never started does
+// nothing, so a failed setup can unwind through its teardown.
+typedef struct {
+    atomic_bool stop;
+    atomic_bool exited;
+    bool started;
+} dual_core_helper_t;
+
+// Create the task at DUAL_CORE_HELPER_PRIORITY, pinned to `core`
+bool dual_core_helper_start(dual_core_helper_t *helper, TaskFunction_t task, const char *name, uint32_t stack,
+                            void *arg, BaseType_t core, TaskHandle_t *handle);
+
+// Last call of the helper task: tells the joiner it is gone and deletes it
+void dual_core_helper_exit(dual_core_helper_t *helper);
+
+// Set `stop`, call `wake` (if any) to unblock a helper waiting on a
+// primitive, and wait until the helper has exited
+void dual_core_helper_join(dual_core_helper_t *helper, void (*wake)(void *arg), void *arg);
+
+// Per-core load and per-task CPU share from FreeRTOS run-time stats
+// (cpu_load.c). Needs CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS and
+// CONFIG_FREERTOS_USE_TRACE_FACILITY; without them cpu_load_update() returns
+// false and prints nothing.
+#define CPU_LOAD_MAX_TASKS 24
+
+typedef struct {
+    void *handle;
+    uint32_t runtime;
+} cpu_load_task_t;
+
+// A baseline to measure from; each user (monitor, whole run) keeps its own
+typedef struct {
+    uint32_t total;
+    uint32_t count;
+    cpu_load_task_t tasks[CPU_LOAD_MAX_TASKS];
+} cpu_load_t;
+
+// Take the baseline sample
+void cpu_load_start(cpu_load_t *load);
+
+// Percent busy per core since the baseline, optionally printed along with a
+// per-task table (CPU share, stack high-water mark); then move the baseline
+// to now. Not reentrant: the task-state scratch buffer is shared.
+bool cpu_load_update(cpu_load_t *load, float busy[2], bool print);
+
+// Keeping a core's idle task alive (periodic.c). A loop that may run flat
+// out -- a saturated worker, a short-period wait, a pipeline stage slower
+// than its input -- would starve the idle task on its core, which trips the
+// task watchdog, and every lower-priority task there, such as the dlog
+// flusher. Such a loop calls idle_yield_check() as it goes and
+// idle_yield_reset() whenever it has blocked; once it has gone IDLE_YIELD_MS
+// without blocking, the check sleeps one tick. Whatever the loop would have
+// done in that tick comes late or is skipped, and each user counts it with
+// its own misses.
+#define IDLE_YIELD_MS 1000
+
+typedef struct {
+    int64_t due;  // esp_timer μs of the next forced sleep
+} idle_yield_t;
+
+// Start the IDLE_YIELD_MS budget over: call at the start and after blocking
+void idle_yield_reset(idle_yield_t *idle);
+
+// Sleep one tick if the budget is used up; true if it slept
+bool idle_yield_check(idle_yield_t *idle);
+
+// Drift-free release grid (periodic.c). Each release is one period after
+// the previous *scheduled* release, not after the previous wake-up, so the
+// loop body's run time never accumulates. Whole ticks are slept and the last
+// stretch is spun on esp_timer, so periods below the tick period work, at the
+// cost of up to two ticks of spinning per release.
+//
+// With periods of two ticks or less the wait never sleeps, so it yields
+// through idle_yield_check(): the releases in that tick are counted as
+// overruns and the one after it shows up as up to a tick of release error,
+// about one release in every hundred at 1 ms periods. An esp_timer callback
+// notifying the loop would block between all releases instead, but adds the
+// esp_timer task's dispatch and a context switch to every one (the jitter
+// benchmark's method 2); the spin keeps μs precision.
+typedef struct {
+    int64_t next;        // next scheduled release, esp_timer μs
+    idle_yield_t idle;
+    uint32_t period_us;
+    uint32_t overruns;   // releases skipped because the loop body took too long, or for a yield
+} periodic_t;
+
+// First release one period from now
+void periodic_start(periodic_t *periodic, uint32_t period_us);
+
+// Wait for the next release; returns how late it came, in μs
+uint32_t periodic_wait(periodic_t *periodic);
+
+// Background load for the benchmarks of this component: the saturated
+// workload (core0_task/core1_task over the queue transport) without the
+// monitor or any reporting, until dual_core_load_stop(). Fails while a
+// workload run is in progress.
+bool dual_core_load_start(void);
+void dual_core_load_stop(void);
@@ -0,0 +1,782 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+#include <math.h>
+#include "bench.h"
+#include "dlog.h"
+#include "spsc_ring.h"
+#include "msg_pool.h"
+#include "mailbox.h"
+#include "overwrite_ring.h"
+#include "varlen_ring.h"
+#include "percore.h"
+#include "seqlock.h"
+#include "dual_core_private.h"
+
+#define SEND_TIMEOUT_MS 100
+#define RECEIVE_TIMEOUT_MS 10
+
+// Variable-length transport: the fixed ring's CORE_QUEUE_LENGTH messages
+// (768 bytes) rounded up to a power of two. The workload's records are about
+// 40 bytes, so some 25 fit.
+#define CORE_VARLEN_BYTES 1024
+
+// Saturated and periodic workers may never sleep, so the monitor sits above
+// them in those modes, or it would never report
+#define UNPACED_MONITOR_PRIORITY 3
+
+// Inter-core communication
+static dual_core_config_t run_config;
+static QueueHandle_t core_queue;
+static spsc_ring_t core_ring;
+static core_message_t core_ring_slots[CORE_QUEUE_LENGTH];
+static msg_pool_t *core_pool;            // zero-copy: messages live here...
+static spsc_ring_t core_index_ring;      // ...and only their pool index crosses cores
+static uint32_t core_index_slots[CORE_QUEUE_LENGTH];
+static mailbox_t core_mailbox;           // lossy: only the newest message...
+static core_message_t core_mailbox_slots[MAILBOX_SLOTS];
+static overwrite_ring_t core_drop_ring;  // ...or the newest CORE_QUEUE_LENGTH
+static core_message_t core_drop_slots[CORE_QUEUE_LENGTH];
+static varlen_ring_t core_var_ring;      // header plus the text actually written
+static uint32_t core_var_storage[CORE_VARLEN_BYTES / sizeof(uint32_t)];
+
+static const char *const transport_names[DUAL_CORE_TRANSPORT_COUNT] = {
+    "queue", "spsc", "pool", "mailbox", "drop_oldest", "varlen"
+};
+
+// Performance counters
+// Each core's task owns one block and republishes it after every
+// iteration; monitor_task reads a consistent snapshot through the seqlock
+// without ever making the writer wait. The blocks are padded to a cache
+// line each so the two writers never touch the same line.
+typedef struct {
+    uint32_t iterations;
+    uint32_t messages;             // sent (core 0) or received (core 1)
+    uint64_t total_cycles;         // CCOUNT of the task's own core
+    uint64_t elapsed_us;           // since the task started
+    uint32_t stalls;               // saturation mode, core 0: messages not sent because the transport was full
+    uint32_t saturation_messages;  // messages sent before the first stall
+    uint64_t saturation_us;        // time from the task's start to the first stall
+    uint32_t overruns;             // periodic mode: releases skipped because an iteration ran long or to yield
+    uint32_t lost;                 // lossy transports, core 0: messages replaced before core 1 took them
+} core_stats_t;
+
+typedef struct {
+    seqlock_t lock;
+    core_stats_t published;
+} core_stats_block_t;
+
+static PERCORE_PADDED(core_stats_block_t) core_stats[2];
+
+static void publish_stats(int core, const core_stats_t *stats) {
+    seqlock_write(&core_stats[core].value.lock, &core_stats[core].value.published, stats, sizeof(*stats));
+}
+
+static core_stats_t snapshot_stats(int core) {
+    core_stats_t copy;
+    seqlock_read(&core_stats[core].value.lock, &copy, &core_stats[core].value.published, sizeof(copy));
+    return copy;
+}
+
+static uint64_t average_cycles(const core_stats_t *stats) {
+    return stats->iterations > 0 ? stats->total_cycles / stats->iterations : 0;
+}
+
+static double per_second(uint32_t count, const core_stats_t *stats) {
+    return stats->elapsed_us > 0 ? count * 1e6 / stats->elapsed_us : 0;
+}
+
+static bench_hist_t latency_hist;  // message latency in μs, written by core1_task only
+static cpu_load_t run_load;        // baseline for the whole run's per-core load
+static bench_hist_t release_error[2];  // periodic mode, μs; written by each core's task only
+static atomic_int workers_running;     // core0_task/core1_task instances not yet finished
+static atomic_bool workers_stop;       // ends the workers' loops early (background load)
+
+const char *dual_core_transport_name(dual_core_transport_t t) {
+    return t < DUAL_CORE_TRANSPORT_COUNT ? transport_names[t] : "?";
+}
+
+bool dual_core_transport_parse(const char *name, dual_core_transport_t *t) {
+    for(int i = 0; i < DUAL_CORE_TRANSPORT_COUNT; i++) {
+        if(strcmp(name, transport_names[i]) == 0) {
+            *t = (dual_core_transport_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Buffer for the next outgoing message: the caller's staging copy for the
+// copying transports, a pool buffer to fill in place for the zero-copy one
+// (NULL while the pool is exhausted)
+static core_message_t *transport_claim(core_message_t *staging) {
+    if(run_config.transport == DUAL_CORE_TRANSPORT_POOL) {
+        return msg_pool_alloc(core_pool);
+    }
+    return staging;
+}
+
+// The lossy transports always accept a message: they make room by
+// replacing the oldest one, which transport_lost() counts
+static bool transport_push(core_message_t *message) {
+    switch(run_config.transport) {
+        case DUAL_CORE_TRANSPORT_SPSC:
+            return spsc_ring_push(&core_ring, message);
+        case DUAL_CORE_TRANSPORT_MAILBOX:
+            mailbox_post(&core_mailbox, message);
+            return true;
+        case DUAL_CORE_TRANSPORT_DROP_OLDEST:
+            overwrite_ring_push(&core_drop_ring, message);
+            return true;
+        case DUAL_CORE_TRANSPORT_VARLEN:
+            // The text's terminator is the last byte sent
+            return varlen_ring_push(&core_var_ring, message,
+                                    offsetof(core_message_t, data) + strlen(message->data) + 1);
+        default: {
+            uint32_t index = msg_pool_index(core_pool, message);
+            return spsc_ring_push(&core_index_ring, &index);
+        }
+    }
+}
+
+// One poll of the transports that never block; the pool's message arrives
+// as an index
+static bool transport_pop(core_message_t *staging, uint32_t *index) {
+    switch(run_config.transport) {
+        case DUAL_CORE_TRANSPORT_SPSC: return spsc_ring_pop(&core_ring, staging);
+        case DUAL_CORE_TRANSPORT_MAILBOX: return mailbox_take(&core_mailbox, staging);
+        case DUAL_CORE_TRANSPORT_DROP_OLDEST: return overwrite_ring_pop(&core_drop_ring, staging);
+        case DUAL_CORE_TRANSPORT_VARLEN: {
+            uint32_t length;
+            return varlen_ring_pop(&core_var_ring, staging, sizeof(*staging), &length);
+        }
+        default: return spsc_ring_pop(&core_index_ring, index);
+    }
+}
+
+// The rings never block, so their side of each call polls until the same
+// timeout the queue would block for. A full ring means core 1 is far behind,
+// so the producer sleeps a tick between attempts; the consumer spins, which
+// is the price of not being woken by the scheduler. The lossy transports are
+// never full, so their producer never waits at all.
+static bool transport_send(core_message_t *message) {
+    if(run_config.transport == DUAL_CORE_TRANSPORT_QUEUE) {
+        return xQueueSend(core_queue, message, pdMS_TO_TICKS(SEND_TIMEOUT_MS)) == pdTRUE;
+    }
+    
+    int64_t deadline = esp_timer_get_time() + SEND_TIMEOUT_MS * 1000;
+    while(!transport_push(message)) {
+        if(esp_timer_get_time() >= deadline) {
+            if(run_config.transport == DUAL_CORE_TRANSPORT_POOL) {
+                msg_pool_free(core_pool, message);  // dropped
+            }
+            return false;
+        }
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+// Next message, or NULL after `timeout_ms` (0: a single poll). Copying
+// transports copy into `staging`; the zero-copy one returns the producer's
+// buffer, which must go back through transport_release().
+static core_message_t *transport_receive(core_message_t *staging, uint32_t timeout_ms) {
+    if(run_config.transport == DUAL_CORE_TRANSPORT_QUEUE) {
+        return xQueueReceive(core_queue, staging, pdMS_TO_TICKS(timeout_ms)) == pdTRUE ? staging : NULL;
+    }
+    
+    uint32_t index;
+    int64_t deadline = esp_timer_get_time() + timeout_ms * 1000;
+    while(!transport_pop(staging, &index)) {
+        if(esp_timer_get_time() >= deadline) {
+            return NULL;
+        }
+    }
+    return run_config.transport == DUAL_CORE_TRANSPORT_POOL ? msg_pool_buffer(core_pool, index) : staging;
+}
+
+// Saturation mode never waits for space: a full transport (or, for the
+// pool, a full index ring) is reported to the caller as a stall and the
+// pool buffer is returned
+static bool transport_try_send(core_message_t *message) {
+    if(run_config.transport == DUAL_CORE_TRANSPORT_QUEUE) {
+        return xQueueSend(core_queue, message, 0) == pdTRUE;
+    }
+    if(transport_push(message)) {
+        return true;
+    }
+    if(run_config.transport == DUAL_CORE_TRANSPORT_POOL) {
+        msg_pool_free(core_pool, message);
+    }
+    return false;
+}
+
+static void transport_release(core_message_t *message) {
+    if(run_config.transport == DUAL_CORE_TRANSPORT_POOL) {
+        msg_pool_free(core_pool, message);
+    }
+}
+
+static uint32_t transport_waiting(void) {
+    switch(run_config.transport) {
+        case DUAL_CORE_TRANSPORT_QUEUE: return uxQueueMessagesWaiting(core_queue);
+        case DUAL_CORE_TRANSPORT_SPSC: return spsc_ring_count(&core_ring);
+        case DUAL_CORE_TRANSPORT_MAILBOX: return mailbox_pending(&core_mailbox);
+        case DUAL_CORE_TRANSPORT_DROP_OLDEST: return overwrite_ring_count(&core_drop_ring);
+        case DUAL_CORE_TRANSPORT_VARLEN: return varlen_ring_count(&core_var_ring);
+        default: return spsc_ring_count(&core_index_ring);
+    }
+}
+
+// Messages the lossy transports replaced before core 1 took them; only
+// core0_task may ask, as the count is the producer's own
+static uint32_t transport_lost(void) {
+    switch(run_config.transport) {
+        case DUAL_CORE_TRANSPORT_MAILBOX: return core_mailbox.overwritten;
+        case DUAL_CORE_TRANSPORT_DROP_OLDEST: return core_drop_ring.dropped;
+        default: return 0;
+    }
+}
+
+// Saturation mode: the workers are busy for duty_percent of every
+// IDLE_YIELD_MS and sleep for the rest; at 100% idle_yield_check() still
+// gives up a tick each period
+typedef struct {
+    int64_t end;         // esp_timer time the run stops
+    int64_t busy_us;     // busy share of each period
+    int64_t busy_until;  // end of the current period's busy share
+    TickType_t last_wake;
+    idle_yield_t idle;
+} saturate_pacer_t;
+
+static void pacer_start(saturate_pacer_t *pacer) {
+    int64_t now = esp_timer_get_time();
+    
+    pacer->busy_us = IDLE_YIELD_MS * 1000LL * run_config.duty_percent / 100;
+    pacer->end = now + run_config.duration_ms * 1000LL;
+    pacer->busy_until = now + pacer->busy_us;
+    pacer->last_wake = xTaskGetTickCount();
+    idle_yield_reset(&pacer->idle);
+}
+
+// Whether the worker should run another iteration; sleeps out the rest of
+// the period first once its busy share is used up
+static bool pacer_continue(saturate_pacer_t *pacer) {
+    int64_t now = esp_timer_get_time();
+    if(now >= pacer->busy_until) {
+        // At 100% duty there is nothing left of the period to sleep
+        if(xTaskDelayUntil(&pacer->last_wake, pdMS_TO_TICKS(IDLE_YIELD_MS)) == pdTRUE) {
+            idle_yield_reset(&pacer->idle);
+        }
+        now = esp_timer_get_time();
+        pacer->busy_until = now + pacer->busy_us;
+    }
+    if(idle_yield_check(&pacer->idle)) {
+        now = esp_timer_get_time();
+    }
+    return now < pacer->end;
+}
+
+// How a worker paces its iterations in each mode
+typedef struct {
+    int iterations;              // paced: fixed count...
+    uint32_t delay_ms;           // ...with a sleep after each iteration
+    saturate_pacer_t pacer;      // saturated
+    periodic_t periodic;         // periodic: drift-free releases...
+    int64_t end;                 // ...until this esp_timer time
+    bench_hist_t *release_error; // ...each release's lateness recorded here, μs
+} worker_pacing_t;
+
+static void pacing_start(worker_pacing_t *pacing, int iterations, uint32_t delay_ms, bench_hist_t *release_error) {
+    memset(pacing, 0, sizeof(*pacing));
+    pacing->iterations = iterations;
+    pacing->delay_ms = delay_ms;
+    pacing->release_error = release_error;
+    if(run_config.mode == DUAL_CORE_MODE_SATURATE) {
+        pacer_start(&pacing->pacer);
+    } else if(run_config.mode == DUAL_CORE_MODE_PERIODIC) {
+        periodic_start(&pacing->periodic, run_config.period_us);
+        pacing->end = esp_timer_get_time() + run_config.duration_ms * 1000LL;
+    }
+}
+
+// Whether iteration `i` should run. Paced workers sleep after every
+// iteration, so the period is the sleep plus the iteration's own run time and
+// drifts with it; periodic ones wait for the next slot on a fixed grid.
+static bool pacing_next(worker_pacing_t *pacing, int i) {
+    if(atomic_load_explicit(&workers_stop, memory_order_relaxed)) {
+        return false;
+    }
+    switch(run_config.mode) {
+        case DUAL_CORE_MODE_PACED:
+            if(i > 0) {
+                vTaskDelay(pdMS_TO_TICKS(pacing->delay_ms));
+            }
+            return i < pacing->iterations;
+        case DUAL_CORE_MODE_SATURATE:
+            return pacer_continue(&pacing->pacer);
+        default:
+            if(pacing->periodic.next >= pacing->end) {
+                return false;
+            }
+            bench_hist_record(pacing->release_error, periodic_wait(&pacing->periodic));
+            return true;
+    }
+}
+
+static void note_stall(core_stats_t *stats, int64_t task_start) {
+    if(stats->stalls++ == 0) {
+        stats->saturation_messages = stats->messages;
+        stats->saturation_us = esp_timer_get_time() - task_start;
+    }
+}
+
+// Task for Core 0 (PRO_CPU)
+static void core0_task(void *parameter) {
+    core_message_t staging;
+    core_stats_t stats = { 0 };
+    worker_pacing_t pacing;
+    // Only the paced heartbeat may block on a full transport or log every
+    // message; the other modes would lose their rate or their period to it
+    bool paced = run_config.mode == DUAL_CORE_MODE_PACED;
+    bool saturate = run_config.mode == DUAL_CORE_MODE_SATURATE;
+    uint64_t task_start = esp_timer_get_time();
+    
+    dlog("Core 0 Task Started (PRO_CPU)\n");
+    
+    pacing_start(&pacing, 100, 50, &release_error[0]);  // 100 iterations, 50ms delay when paced
+    for(int i = 0; pacing_next(&pacing, i); i++) {
+        bench_timer_t iteration_timer;
+        bench_timer_start(&iteration_timer);
+        
+        // Simulate protocol processing work
+        uint32_t checksum = 0;
+        for(int j = 0; j < 1000; j++) {
+            checksum += j * 997;  // Some computation
+        }
+        
+        // Send message to Core 1 every 10 iterations, or every iteration
+        // when saturating
+        bool send = saturate || i % 10 == 0;
+        core_message_t *message = send ? transport_claim(&staging) : NULL;
+        if(message != NULL) {
+            message->sender_core = 0;
+            message->message_id = i;
+            message->timestamp = esp_timer_get_time();
+            snprintf(message->data, sizeof(message->data), "Hello from Core 0 #%d", i);
+            
+            if(!paced) {
+                if(transport_try_send(message)) {
+                    stats.messages++;
+                } else {
+                    note_stall(&stats, task_start);
+                }
+            } else if(transport_send(message)) {
+                stats.messages++;
+                dlog("Core 0: Sent message %d\n", i);
+            }
+        } else if(send && !paced) {
+            note_stall(&stats, task_start);  // every pool buffer is in flight
+        }
+        stats.lost = transport_lost();
+        
+        stats.iterations++;
+        stats.total_cycles += bench_timer_stop(&iteration_timer);
+        stats.elapsed_us = esp_timer_get_time() - task_start;
+        stats.overruns = pacing.periodic.overruns;
+        publish_stats(0, &stats);
+    }
+    
+    uint64_t task_end = esp_timer_get_time();
+    dlog("Core 0 Task Completed in %llu ms\n", (task_end - task_start) / 1000);
+    atomic_fetch_sub(&workers_running, 1);
+    vTaskDelete(NULL);
+}
+
+// Task for Core 1 (APP_CPU)
+static void core1_task(void *parameter) {
+    core_message_t staging;
+    core_stats_t stats = { 0 };
+    worker_pacing_t pacing;
+    bool paced = run_config.mode == DUAL_CORE_MODE_PACED;
+    // A periodic loop only polls: waiting for a message would cost it its period
+    uint32_t receive_timeout_ms = run_config.mode == DUAL_CORE_MODE_PERIODIC ? 0 : RECEIVE_TIMEOUT_MS;
+    uint64_t task_start = esp_timer_get_time();
+    
+    dlog("Core 1 Task Started (APP_CPU)\n");
+    
+    pacing_start(&pacing, 150, 30, &release_error[1]);  // 150 iterations, 30ms delay when paced
+    for(int i = 0; pacing_next(&pacing, i); i++) {
+        bench_timer_t iteration_timer;
+        bench_timer_start(&iteration_timer);
+        
+        // Simulate application processing work
+        float result = 0.0;
+        for(int j = 0; j < 500; j++) {
+            result += sqrt(j * 1.7f);  // Floating point computation
+        }
+        
+        // Check for messages from Core 0
+        core_message_t *received_message = transport_receive(&staging, receive_timeout_ms);
+        if(received_message != NULL) {
+            uint64_t latency = esp_timer_get_time() - received_message->timestamp;
+            stats.messages++;
+            bench_hist_record(&latency_hist, (uint32_t)latency);
+            if(paced) {
+                dlog("Core 1: Received message %lu (latency: %llu μs)\n",
+                     received_message->message_id, latency);
+            }
+            transport_release(received_message);
+        }
+        
+        stats.iterations++;
+        stats.total_cycles += bench_timer_stop(&iteration_timer);
+        stats.elapsed_us = esp_timer_get_time() - task_start;
+        stats.overruns = pacing.periodic.overruns;
+        publish_stats(1, &stats);
+    }
+    
+    uint64_t task_end = esp_timer_get_time();
+    dlog("Core 1 Task Completed in %llu ms\n", (task_end - task_start) / 1000);
+    atomic_fetch_sub(&workers_running, 1);
+    vTaskDelete(NULL);
+}
+
+// Monitoring task (can run on either core)
+static void monitor_task(void *parameter) {
+    static bench_hist_t latency_snapshot;  // too big for the monitor's stack
+    static cpu_load_t monitor_load;
+    bool saturate = run_config.mode == DUAL_CORE_MODE_SATURATE;
+    bool periodic = run_config.mode == DUAL_CORE_MODE_PERIODIC;
+    int seconds = saturate || periodic ? (run_config.duration_ms + 999) / 1000 : 10;
+    TickType_t last_wake_time = xTaskGetTickCount();
+    float busy[2];
+    
+    cpu_load_start(&monitor_load);
+    for(int i = 0; i < seconds; i++) {
+        vTaskDelayUntil(&last_wake_time, pdMS_TO_TICKS(1000));  // Every 1 second
+        
+        dlog("\n=== Performance Monitor (Second %d) ===\n", i + 1);
+        core_stats_t core0 = snapshot_stats(0);
+        core_stats_t core1 = snapshot_stats(1);
+        uint64_t core0_avg = average_cycles(&core0);
+        uint64_t core1_avg = average_cycles(&core1);
+        dlog("Core 0 iterations: %lu (avg: %.1f μs, %llu cycles)\n", 
+             core0.iterations, bench_cycles_to_us(core0_avg), core0_avg);
+        dlog("Core 1 iterations: %lu (avg: %.1f μs, %llu cycles)\n", 
+             core1.iterations, bench_cycles_to_us(core1_avg), core1_avg);
+        dlog("Messages waiting (%s): %lu\n", transport_names[run_config.transport], transport_waiting());
+        if(core0.lost > 0) {
+            dlog("Messages replaced before core 1 took them: %lu\n", core0.lost);
+        }
+        if(saturate) {
+            dlog("Rate: core 0 %.0f it/s, core 1 %.0f it/s, %.0f msg/s, %lu stalls\n",
+                 per_second(core0.iterations, &core0), per_second(core1.iterations, &core1),
+                 per_second(core1.messages, &core1), core0.stalls);
+        }
+        if(periodic) {
+            dlog("Release error p99: core 0 %lu μs, core 1 %lu μs; overruns %lu / %lu\n",
+                 bench_hist_percentile(&release_error[0], 99.0), bench_hist_percentile(&release_error[1], 99.0),
+                 core0.overruns, core1.overruns);
+        }
+        
+        // Copy first so the percentiles all come from the same set of samples
+        bench_hist_reset(&latency_snapshot);
+        bench_hist_merge(&latency_snapshot, &latency_hist);
+        dlog("Message latency: n %lu, p50 %lu, p90 %lu, p99 %lu, p99.9 %lu, max %lu μs\n",
+             latency_snapshot.count, bench_hist_percentile(&latency_snapshot, 50.0),
+             bench_hist_percentile(&latency_snapshot, 90.0), bench_hist_percentile(&latency_snapshot, 99.0),
+             bench_hist_percentile(&latency_snapshot, 99.9), latency_snapshot.count ? latency_snapshot.max : 0);
+        dlog("Free heap: %d bytes\n", esp_get_free_heap_size());
+        
+        // The load table is printed directly, so flush the lines above
+        // first. When saturating this is also the only regular flush: the
+        // log task sits below the workers and only runs in their sleeps.
+        dlog_flush();
+        cpu_load_update(&monitor_load, busy, true);
+    }
+    
+    vTaskDelete(NULL);
+}
+
+static bool prepare_run(const dual_core_config_t *config) {
+    run_config = *config;
+    atomic_store(&workers_stop, false);
+    
+    // Create synchronization objects once; later runs reuse them
+    if(core_queue == NULL) {
+        core_queue = xQueueCreate(CORE_QUEUE_LENGTH, sizeof(core_message_t));
+    }
+    // Worker output goes through the deferred log; its formatter runs below
+    // the workers' priority so printing never lands in a timed iteration
+    if(!dlog_start(1)) {
+        printf("Failed to start the log task!\n");
+        return false;
+    }
+    
+    uint32_t index;
+    while(core_pool != NULL && spsc_ring_pop(&core_index_ring, &index)) {
+        msg_pool_free(core_pool, msg_pool_buffer(core_pool, index));  // left over from the last run
+    }
+    if(core_pool == NULL) {
+        // Ring depth plus the message being filled and the one being read
+        core_pool = msg_pool_create(sizeof(core_message_t), CORE_QUEUE_LENGTH + 2, MALLOC_CAP_INTERNAL);
+    }
+    
+    if(core_queue == NULL || core_pool == NULL ||
+       !spsc_ring_init(&core_ring, core_ring_slots, sizeof(core_message_t), CORE_QUEUE_LENGTH) ||
+       !spsc_ring_init(&core_index_ring, core_index_slots, sizeof(uint32_t), CORE_QUEUE_LENGTH) ||
+       !mailbox_init(&core_mailbox, core_mailbox_slots, sizeof(core_message_t)) ||
+       !overwrite_ring_init(&core_drop_ring, core_drop_slots, sizeof(core_message_t), CORE_QUEUE_LENGTH) ||
+       !varlen_ring_init(&core_var_ring, core_var_storage, sizeof(core_var_storage))) {
+        printf("Failed to create synchronization objects!\n");
+        return false;
+    }
+    
+    xQueueReset(core_queue);
+    memset(core_stats, 0, sizeof(core_stats));
+    bench_hist_reset(&latency_hist);
+    bench_hist_reset(&release_error[0]);
+    bench_hist_reset(&release_error[1]);
+    cpu_load_start(&run_load);
+    return true;
+}
+
+static bool start_workers(void) {
+    // Create tasks pinned to specific cores. Count them first so a worker
+    // that finishes at once cannot take the count below zero.
+    atomic_fetch_add(&workers_running, 2);
+    BaseType_t core0_result = xTaskCreatePinnedToCore(
+        core0_task,           // Task function
+        "Core0Task",          // Name
+        4096,                 // Stack size
+        NULL,                 // Parameters
+        2,                    // Priority
+        NULL,                 // Task handle
+        0                     // Core 0 (PRO_CPU)
+    );
+    
+    BaseType_t core1_result = xTaskCreatePinnedToCore(
+        core1_task,           // Task function
+        "Core1Task",          // Name
+        4096,                 // Stack size
+        NULL,                 // Parameters
+        2,                    // Priority
+        NULL,                 // Task handle
+        1                     // Core 1 (APP_CPU)
+    );
+    
+    if(core0_result != pdPASS) {
+        atomic_fetch_sub(&workers_running, 1);
+    }
+    if(core1_result != pdPASS) {
+        atomic_fetch_sub(&workers_running, 1);
+    }
+    return core0_result == pdPASS && core1_result == pdPASS;
+}
+
+bool dual_core_suite_run(const dual_core_config_t *config) {
+    dual_core_config_t defaults = DUAL_CORE_CONFIG_DEFAULT;
+    if(config == NULL) {
+        config = &defaults;
+    }
+    if(config->transport >= DUAL_CORE_TRANSPORT_COUNT) {
+        printf("Unknown transport %d\n", config->transport);
+        return false;
+    }
+    if(atomic_load(&workers_running) != 0) {
+        printf("The workload is still running\n");
+        return false;
+    }
+    bool saturate = config->mode == DUAL_CORE_MODE_SATURATE;
+    bool periodic = config->mode == DUAL_CORE_MODE_PERIODIC;
+    if(saturate && (config->duration_ms == 0 || config->duty_percent < 1 || config->duty_percent > 100)) {
+        printf("Saturation mode needs a duration and a duty cycle of 1-100%%\n");
+        return false;
+    }
+    if(periodic && (config->duration_ms == 0 || config->period_us == 0)) {
+        printf("Periodic mode needs a duration and a period\n");
+        return false;
+    }
+    if(!prepare_run(config)) {
+        return false;
+    }
+    
+    if(saturate) {
+        printf("Creating tasks (transport: %s, saturating for %lu ms at %lu%% duty)...\n",
+               transport_names[run_config.transport], run_config.duration_ms, run_config.duty_percent);
+    } else if(periodic) {
+        printf("Creating tasks (transport: %s, every %lu μs for %lu ms)...\n",
+               transport_names[run_config.transport], run_config.period_us, run_config.duration_ms);
+    } else {
+        printf("Creating tasks (transport: %s)...\n", transport_names[run_config.transport]);
+    }
+    
+    bool workers_result = start_workers();
+    
+    BaseType_t monitor_result = xTaskCreate(
+        monitor_task,         // Task function
+        "MonitorTask",        // Name
+        4096,                 // Stack size (printf of floats for the load table)
+        NULL,                 // Parameters
+        saturate || periodic ? UNPACED_MONITOR_PRIORITY : 1,  // Priority (lower than worker tasks when paced)
+        NULL                  // Task handle
+    );
+    
+    if(!workers_result || monitor_result != pdPASS) {
+        printf("Failed to create tasks!\n");
+        return false;
+    }
+    
+    printf("Tasks created successfully. Monitoring dual-core performance...\n\n");
+    
+    // Main task becomes idle. A saturating worker notices the end of the run
+    // at most one pacing period late.
+    uint32_t wait_ms = 12000;
+    if(saturate) {
+        wait_ms = run_config.duration_ms + IDLE_YIELD_MS + 500;
+    } else if(periodic) {
+        wait_ms = run_config.duration_ms + 500;
+    }
+    vTaskDelay(pdMS_TO_TICKS(wait_ms));
+    
+    dlog_flush();
+    printf("\n=== Final Results ===\n");
+    core_stats_t core0 = snapshot_stats(0);
+    core_stats_t core1 = snapshot_stats(1);
+    float busy[2];
+    bool have_load = cpu_load_update(&run_load, busy, false);
+    printf("Core 0 total iterations: %lu\n", core0.iterations);
+    printf("Core 1 total iterations: %lu\n", core1.iterations);
+    uint64_t core0_avg = average_cycles(&core0);
+    uint64_t core1_avg = average_cycles(&core1);
+    printf("Core 0 average time per iteration: %.1f μs (%llu cycles)\n", 
+           bench_cycles_to_us(core0_avg), core0_avg);
+    printf("Core 1 average time per iteration: %.1f μs (%llu cycles)\n", 
+           bench_cycles_to_us(core1_avg), core1_avg);
+    double latency_avg = latency_hist.count > 0 ? (double)latency_hist.sum / latency_hist.count : 0;
+    printf("Messages: %lu sent, %lu received (avg latency: %.1f μs)\n",
+           core0.messages, core1.messages, latency_avg);
+    if(core0.lost > 0) {
+        printf("Messages replaced before core 1 took them: %lu\n", core0.lost);
+    }
+    bench_hist_print("Message latency", &latency_hist, "μs");
+    if(have_load) {
+        printf("CPU load over the run: core 0 %.1f%%, core 1 %.1f%%\n", busy[0], busy[1]);
+    } else {
+        printf("CPU load: not available (enable CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS)\n");
+    }
+    if(saturate) {
+        printf("Core 0 rate: %.0f iterations/s\n", per_second(core0.iterations, &core0));
+        printf("Core 1 rate: %.0f iterations/s\n", per_second(core1.iterations, &core1));
+        printf("Message rate: %.0f/s delivered, %lu of %lu offered stalled on a full transport\n",
+               per_second(core1.messages, &core1), core0.stalls, core0.messages + core0.stalls);
+        if(core0.stalls > 0) {
+            printf("Transport saturated after %.1f ms (%lu messages sent)\n",
+                   core0.saturation_us / 1000.0, core0.saturation_messages);
+        } else {
+            printf("Transport never saturated\n");
+        }
+    }
+    if(periodic) {
+        bench_hist_print("Core 0 release error", &release_error[0], "μs");
+        bench_hist_print("Core 1 release error", &release_error[1], "μs");
+        printf("Overruns: core 0 %lu, core 1 %lu; stalls: %lu\n", core0.overruns, core1.overruns, core0.stalls);
+    }
+    if(dlog_dropped() > 0) {
+        printf("Log records dropped: %lu\n", (unsigned long)dlog_dropped());
+    }
+    
+    // Saturated runs carry their mode and duty cycle so they never merge
+    // with the paced heartbeat's figures
+    char params[64];
+    char mode[32] = "";
+    const char *name = transport_names[run_config.transport];
+    if(saturate) {
+        snprintf(mode, sizeof(mode), " mode=saturate duty=%lu", run_config.duty_percent);
+    } else if(periodic) {
+        snprintf(mode, sizeof(mode), " mode=periodic period_us=%lu", run_config.period_us);
+    }
+    snprintf(params, sizeof(params), "core=0 transport=%s%s", name, mode);
+    bench_report_metric("dualcore", "iterations", params, "count", core0.iterations, true);
+    bench_report_metric("dualcore", "iteration_cycles", params, "cycles", core0_avg, false);
+    if(saturate) {
+        bench_report_metric("dualcore", "iteration_rate", params, "1/s", per_second(core0.iterations, &core0), true);
+    }
+    if(have_load) {
+        bench_report_metric("dualcore", "cpu_load", params, "%", busy[0], false);
+    }
+    if(periodic) {
+        bench_hist_report("dualcore", "release_error", params, "us", &release_error[0]);
+        bench_report_metric("dualcore", "overruns", params, "count", core0.overruns, false);
+    }
+    snprintf(params, sizeof(params), "core=1 transport=%s%s", name, mode);
+    bench_report_metric("dualcore", "iterations", params, "count", core1.iterations, true);
+    bench_report_metric("dualcore", "iteration_cycles", params, "cycles", core1_avg, false);
+    if(saturate) {
+        bench_report_metric("dualcore", "iteration_rate", params, "1/s", per_second(core1.iterations, &core1), true);
+    }
+    if(have_load) {
+        bench_report_metric("dualcore", "cpu_load", params, "%", busy[1], false);
+    }
+    if(periodic) {
+        bench_hist_report("dualcore", "release_error", params, "us", &release_error[1]);
+        bench_report_metric("dualcore", "overruns", params, "count", core1.overruns, false);
+    }
+    snprintf(params, sizeof(params), "transport=%s%s", name, mode);
+    bench_report_metric("dualcore", "messages", params, "count", core1.messages, true);
+    bench_report_metric("dualcore", "message_latency", params, "us", latency_avg, false);
+    bench_hist_report("dualcore", "message_latency", params, "us", &latency_hist);
+    if(run_config.transport == DUAL_CORE_TRANSPORT_MAILBOX || run_config.transport == DUAL_CORE_TRANSPORT_DROP_OLDEST) {
+        bench_report_metric("dualcore", "messages_lost", params, "count", core0.lost, false);
+    }
+    if(saturate) {
+        bench_report_metric("dualcore", "message_rate", params, "1/s", per_second(core1.messages, &core1), true);
+        bench_report_metric("dualcore", "send_stalls", params, "count", core0.stalls, false);
+        if(core0.stalls > 0) {
+            bench_report_metric("dualcore", "saturation_time", params, "ms", core0.saturation_us / 1000.0, true);
+            bench_report_metric("dualcore", "saturation_messages", params, "count", core0.saturation_messages, true);
+        }
+    }
+    return true;
+}
+
+bool dual_core_load_start(void) {
+    dual_core_config_t config = DUAL_CORE_CONFIG_DEFAULT;
+    config.mode = DUAL_CORE_MODE_SATURATE;
+    config.duration_ms = UINT32_MAX;  // until dual_core_load_stop()
+    
+    if(atomic_load(&workers_running) != 0 || !prepare_run(&config)) {
+        return false;
+    }
+    if(!start_workers()) {
+        dual_core_load_stop();
+        return false;
+    }
+    return true;
+}
+
+void dual_core_load_stop(void) {
+    atomic_store(&workers_stop, true);
+    while(atomic_load(&workers_running) != 0) {
+        vTaskDelay(1);
+    }
+}
+
+int dual_core_suite_run_benchmarks(void) {
+    int cases = 0;
+    for(const bench_def_t *def = bench_first(); def; def = def->next) {
+        if(strcmp(def->group, "dualcore") == 0) {
+            cases += bench_run(def);
+        }
+    }
+    return cases;
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include <stdatomic.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_heap_caps.h>
+#include "bench.h"
+#include "percore.h"
+#include "dual_core_private.h"
+
+// Cross-core interference between counters. Core 0 (the measuring task)
+// bumps its own count/total pair while a helper on core 1 bumps the other
+// core's pair as fast as it can; cycles/element is core 0's cost per update.
+//
+// "layout" parameter:
+//   0 alone     core 0's counter only, helper not running: the baseline
+//   1 adjacent  both pairs packed back to back, as plain statics or an array
+//               of structs lay them out: one 32-byte line holds both cores'
+//   2 padded    percore_counter_t, one cache line per core
+//
+// "region" parameter: 0 internal SRAM, 1 PSRAM (skipped when there is none).
+// Internal SRAM is not cached on the ESP32, so any cost there is contention
+// for the same SRAM bank; PSRAM is reached through the cache, where sharing a
+// line is what costs.
+
+#define FALSE_SHARING_UPDATES 4096
+#define FALSE_SHARING_HELPER_BATCH 64
+
+enum { FS_ALONE, FS_ADJACENT, FS_PADDED, FS_LAYOUT_COUNT };
+enum { FS_SRAM, FS_PSRAM, FS_REGION_COUNT };
+
+// The same fields as percore_counter_t without the alignment
+typedef struct {
+    uint32_t count;
+    uint64_t total;
+} packed_counter_t;
+
+typedef struct {
+    void *counters;                 // two counters, `stride` bytes apart
+    size_t stride;
+    atomic_bool running;            // helper has started updating
+    dual_core_helper_t helper;
+} false_sharing_run_t;
+
+// Every update is a load and a store of both fields; volatile keeps them in
+// memory rather than in registers across the loop
+static void bump(volatile uint32_t *count, volatile uint64_t *total, uint32_t updates) {
+    for(uint32_t i = 0; i < updates; i++) {
+        *count += 1;
+        *total += i;
+    }
+}
+
+static void bump_counter(false_sharing_run_t *run, int core, uint32_t updates) {
+    uint8_t *base = (uint8_t *)run->counters + core * run->stride;
+    if(run->stride == sizeof(percore_counter_t)) {
+        percore_counter_t *counter = (percore_counter_t *)base;
+        bump(&counter->count, &counter->total, updates);
+    } else {
+        packed_counter_t *counter = (packed_counter_t *)base;
+        bump(&counter->count, &counter->total, updates);
+    }
+}
+
+static void false_sharing_helper_task(void *parameter) {
+    false_sharing_run_t *run = parameter;
+
+    atomic_store_explicit(&run->running, true, memory_order_release);
+    while(!atomic_load_explicit(&run->helper.stop, memory_order_acquire)) {
+        bump_counter(run, 1, FALSE_SHARING_HELPER_BATCH);
+    }
+
+    dual_core_helper_exit(&run->helper);
+}
+
+static void false_sharing_teardown(bench_case_t *c);
+
+static bool false_sharing_setup(bench_case_t *c) {
+    static const char *const names[] = { "Internal SRAM", "PSRAM" };
+    int32_t layout = c->values[0];
+    int32_t region = c->values[1];
+    if(layout < 0 || layout >= FS_LAYOUT_COUNT || region < 0 || region >= FS_REGION_COUNT) {
+        return false;
+    }
+
+    false_sharing_run_t *run = heap_caps_calloc(1, sizeof(false_sharing_run_t), MALLOC_CAP_INTERNAL);
+    if(run == NULL) {
+        return false;
+    }
+    c->state = run;
+
+    // Line-aligned in both layouts, so "adjacent" shares exactly one line
+    // and "padded" uses exactly two
+    run->stride = layout == FS_PADDED ? sizeof(percore_counter_t) : sizeof(packed_counter_t);
+    uint32_t caps = (region == FS_SRAM ? MALLOC_CAP_INTERNAL : MALLOC_CAP_SPIRAM) | MALLOC_CAP_8BIT;
+    run->counters = heap_caps_aligned_calloc(PERCORE_CACHE_LINE, 2, run->stride, caps);
+    if(run->counters == NULL) {
+        false_sharing_teardown(c);
+        return false;
+    }
+
+    if(layout != FS_ALONE) {
+        if(!dual_core_helper_start(&run->helper, false_sharing_helper_task, "FalseShare", 2048, run,
+                                   DUAL_CORE_HELPER_CORE, NULL)) {
+            false_sharing_teardown(c);
+            return false;
+        }
+        while(!atomic_load_explicit(&run->running, memory_order_acquire)) {
+            vTaskDelay(1);
+        }
+    }
+
+    c->memory = names[region];
+    c->elements = FALSE_SHARING_UPDATES;
+    return true;
+}
+
+static void false_sharing_run(bench_case_t *c) {
+    bump_counter(c->state, 0, FALSE_SHARING_UPDATES);
+}
+
+static void false_sharing_teardown(bench_case_t *c) {
+    false_sharing_run_t *run = c->state;
+
+    dual_core_helper_join(&run->helper, NULL, NULL);
+
+    if(run->counters) {
+        heap_caps_free(run->counters);
+    }
+    heap_caps_free(run);
+}
+
+BENCH_DEFINE(dualcore_false_sharing, "dualcore", "false_sharing",
+             false_sharing_setup, false_sharing_run, false_sharing_teardown,
+             BENCH_PARAM("layout", FS_ALONE, FS_ADJACENT, FS_PADDED),
+             BENCH_PARAM("region", FS_SRAM, FS_PSRAM))
@@ -0,0 +1,29 @@
+#include "dual_core_private.h"
+
+bool dual_core_helper_start(dual_core_helper_t *helper, TaskFunction_t task, const char *name, uint32_t stack,
+                            void *arg, BaseType_t core, TaskHandle_t *handle) {
+    atomic_store(&helper->stop, false);
+    atomic_store(&helper->exited, false);
+    helper->started = xTaskCreatePinnedToCore(task, name, stack, arg, DUAL_CORE_HELPER_PRIORITY, handle,
+                                              core) == pdPASS;
+    return helper->started;
+}
+
+void dual_core_helper_exit(dual_core_helper_t *helper) {
+    atomic_store_explicit(&helper->exited, true, memory_order_release);
+    vTaskDelete(NULL);
+}
+
+void dual_core_helper_join(dual_core_helper_t *helper, void (*wake)(void *arg), void *arg) {
+    if(!helper->started) {
+        return;
+    }
+    atomic_store_explicit(&helper->stop, true, memory_order_release);
+    if(wake != NULL) {
+        wake(arg);
+    }
+    while(!atomic_load_explicit(&helper->exited, memory_order_acquire)) {
+        vTaskDelay(1);
+    }
+    helper->started = false;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdbool.h>
+
+// Dual-core workload (group "dualcore"): a protocol-style task pinned to
+// core 0 sends messages to an application-style task pinned to core 1 while
+// a monitor task reports progress once per second; dual_core_pipeline_run()
+// runs the same work as a multi-stage pipeline (pipeline.h). The component also
+// registers core-to-core transport, variable-length messaging, producer
+// stall, round-trip, false-sharing, periodic release jitter, interrupt
+// latency and job placement benchmarks in the same group.
+
+// How core0_task hands messages to core1_task
+typedef enum {
+    DUAL_CORE_TRANSPORT_QUEUE,  // FreeRTOS queue (spinlock + possible context switch per call)
+    DUAL_CORE_TRANSPORT_SPSC,   // lock-free single-producer/single-consumer ring, polled
+    DUAL_CORE_TRANSPORT_POOL,   // zero-copy: pooled buffers filled in place, SPSC ring of indices
+    // Lossy: sending never waits or fails, the oldest unread message is replaced instead
+    DUAL_CORE_TRANSPORT_MAILBOX,      // latest value only (lock-free triple buffer)
+    DUAL_CORE_TRANSPORT_DROP_OLDEST,  // ring of the newest CORE_QUEUE_LENGTH messages
+    // Variable length: a lock-free ring of length-prefixed records, so only
+    // the header and the text actually written cross cores
+    DUAL_CORE_TRANSPORT_VARLEN,
+    DUAL_CORE_TRANSPORT_COUNT
+} dual_core_transport_t;
+
+typedef enum {
+    DUAL_CORE_MODE_PACED,     // fixed iteration counts with 50 ms / 30 ms sleeps, a message every 10th iteration
+    DUAL_CORE_MODE_SATURATE,  // no sleeps for duration_ms, a message every iteration: the maximum sustainable rate
+    DUAL_CORE_MODE_PERIODIC,  // both workers released every period_us on a drift-free grid for duration_ms
+} dual_core_mode_t;
+
+typedef struct {
+    dual_core_transport_t transport;
+    dual_core_mode_t mode;
+    uint32_t duration_ms;   // saturation and periodic modes: how long the workers run
+    uint32_t duty_percent;  // saturation mode: busy share of every second, 1-100
+    uint32_t period_us;     // periodic mode: release period, may be below the tick period
+} dual_core_config_t;
+
+#define DUAL_CORE_CONFIG_DEFAULT                                                                \
+    { .transport = DUAL_CORE_TRANSPORT_QUEUE, .mode = DUAL_CORE_MODE_PACED, .duration_ms = 5000, \
+      .duty_percent = 100, .period_us = 1000 }
+
+// "queue", "spsc", "pool", "mailbox", "drop_oldest", "varlen"
+const char *dual_core_transport_name(dual_core_transport_t transport);
+
+// Parse a transport name; false if unknown
+bool dual_core_transport_parse(const char *name, dual_core_transport_t *transport);
+
+// Create the tasks, wait for them to finish (~12 s paced, about
+// duration_ms + 1.5 s saturated, duration_ms + 0.5 s periodic) and print the final results. `config` may
+// be NULL for the defaults. Returns false if the configuration is invalid or
+// the tasks or their transport could not be created.
+bool dual_core_suite_run(const dual_core_config_t *config);
+
+// Pipeline variant of the workload (pipeline.h): produce -> parse on core 0,
+// transform -> sink on core 1, bounded channels between every pair of stages
+typedef struct {
+    uint32_t duration_ms;
+    uint32_t period_us;     // one item from the source per period
+    uint32_t capacity;      // depth of every channel
+    bool drop;              // full channels drop items instead of blocking the stage before them
+} dual_core_pipeline_config_t;
+
+#define DUAL_CORE_PIPELINE_CONFIG_DEFAULT \
+    { .duration_ms = 5000, .period_us = 1000, .capacity = 16, .drop = false }
+
+// Run the pipeline for duration_ms, then print per-stage throughput, busy
+// share, channel occupancy and drops, the end-to-end latency, the bottleneck
+// stage and the per-core load. `config` may be NULL for the defaults.
+bool dual_core_pipeline_run(const dual_core_pipeline_config_t *config);
+
+// Run the registered "dualcore" benchmarks: transport throughput and latency
+// per payload size, fixed slots vs variable-length records under a mixed
+// message size distribution, producer stall time behind a slow consumer for the
+// blocking queue and the lossy transports, the round-trip distribution of
+// each FreeRTOS signalling primitive (pingpong), counter false sharing,
+// periodic release jitter, timer interrupt to task latency per wake-up
+// primitive and core, and static pinning vs a shared queue vs work stealing
+// under skewed jobs
+int dual_core_suite_run_benchmarks(void);
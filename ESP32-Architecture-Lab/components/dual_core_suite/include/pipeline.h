@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include "bench_hist.h"
+
+// Multi-stage pipeline: one task per stage, each with its own core and
+// priority, connected by bounded channels (FreeRTOS queues of item
+// pointers). Items come from a fixed pool sized so that a stage never waits
+// for a buffer: every item is in a channel, held by a stage or free.
+//
+// The first stage is the source. It is called with an empty item over and
+// over until the pipeline stops: once every period_us, released by an
+// esp_timer and blocked in between, or back to back when period_us is 0. A
+// periodic source should have a higher priority than the stages on its core,
+// or its releases wait for their time slice. Every later stage is called
+// with each item from its input channel; the last stage is the sink, after
+// which the item's end-to-end latency is recorded and the item is freed. Any
+// stage may return false to consume an item early (a filter).
+//
+// Each channel has a policy for when it is full: PIPELINE_BLOCK makes the
+// upstream stage wait (backpressure propagates towards the source), and
+// PIPELINE_DROP discards the new item and counts it against the downstream
+// stage. pipeline_report() prints per-stage throughput, busy share, input
+// occupancy and drops, and names the bottleneck. A stage that never has to
+// wait for input sleeps a tick now and then so its core can go idle.
+
+#define PIPELINE_MAX_STAGES 6
+#define PIPELINE_POLL_MS 10  // how often blocked stages look at the stop flag
+
+typedef enum {
+    PIPELINE_BLOCK,  // a full channel stalls the upstream stage
+    PIPELINE_DROP,   // a full channel discards the item
+} pipeline_policy_t;
+
+typedef struct {
+    uint32_t seq;           // source order
+    uint64_t created_us;    // esp_timer time the source produced it
+    uint8_t data[];         // item_size bytes of payload
+} pipeline_item_t;
+
+// False consumes the item here: later stages do not see it
+typedef bool (*pipeline_stage_fn_t)(void *ctx, pipeline_item_t *item);
+
+typedef struct {
+    const char *name;
+    pipeline_stage_fn_t fn;
+    void *ctx;
+    BaseType_t core;            // or tskNO_AFFINITY
+    UBaseType_t priority;
+    uint32_t capacity;          // depth of this stage's input channel; unused for the source
+    pipeline_policy_t policy;   // when that channel is full
+    uint32_t period_us;         // source only: release period, 0 to saturate
+} pipeline_stage_config_t;
+
+// Written by the stage's own task, except `dropped`, which the upstream
+// stage's task counts. Read them after pipeline_stop().
+typedef struct {
+    uint32_t items;             // items this stage processed
+    uint32_t dropped;           // items discarded at this stage's full input channel; for
+                                // the source, releases skipped because it was still busy
+    uint32_t filtered;          // items this stage consumed early
+    uint64_t busy_us;           // time spent in the stage function
+    uint64_t stall_us;          // time blocked on a full output channel
+    uint64_t occupancy_sum;     // input channel depth, sampled at every receive
+    uint32_t occupancy_max;
+} pipeline_stage_stats_t;
+
+typedef struct pipeline pipeline_t;
+
+// Validates the configuration and creates the channels and the item pool;
+// no task runs until pipeline_start(). NULL on failure.
+pipeline_t *pipeline_create(const pipeline_stage_config_t *stages, uint32_t count, uint32_t item_size);
+
+// Create the stage tasks, downstream first. False if one could not be
+// created; the pipeline is then stopped again.
+bool pipeline_start(pipeline_t *pipeline);
+
+// Stop every stage and wait until their tasks have exited. Items still in
+// the channels go back to the pool unprocessed; the statistics are kept, so
+// a restarted pipeline accumulates onto them.
+void pipeline_stop(pipeline_t *pipeline);
+void pipeline_delete(pipeline_t *pipeline);
+
+const pipeline_stage_stats_t *pipeline_stage_stats(const pipeline_t *pipeline, uint32_t stage);
+
+// End-to-end latency of the items that reached the sink, in μs
+const bench_hist_t *pipeline_latency(const pipeline_t *pipeline);
+
+// Print the per-stage table for a run of `elapsed_us` and report it as
+// metrics: pipeline_throughput, pipeline_busy, pipeline_occupancy and
+// pipeline_drops per stage (params "stage=<name>" plus `params`, which may
+// be NULL), and the end-to-end latency distribution as pipeline_latency.
+// Returns the index of the bottleneck stage: the one with the highest busy
+// share, which bounds the throughput of everything upstream of it.
+uint32_t pipeline_report(const pipeline_t *pipeline, uint64_t elapsed_us, const char *params);
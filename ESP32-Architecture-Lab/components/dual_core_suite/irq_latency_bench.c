@@ -0,0 +1,267 @@
+#include <stdio.h>
+#include <stdatomic.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <driver/gptimer.h>
+#include <esp_attr.h>
+#include <esp_heap_caps.h>
+#include "bench.h"
+#include "dual_core_private.h"
+
+// Hardware event to task latency. A one-shot GPTimer alarm is the event: the
+// ISR callback reads the timer's counter and wakes a waiter task through the
+// chosen primitive, and the waiter reads the counter again once it runs. The
+// counter is one clock for both cores, so the cross-core case needs no cycle
+// counter translation. Each timed run is one event: the measuring task on
+// core 0 arms the alarm and blocks until the waiter has recorded it. Three
+// distributions are reported at teardown, in ns:
+//
+//   irq_entry    alarm -> ISR callback
+//   irq_to_task  ISR callback -> waiter running
+//   irq_latency  alarm -> waiter running
+//
+// A run whose event has not reached the measuring task after
+// IRQ_EVENT_TIMEOUT_MS gives up and is counted as timed out.
+//
+// "wake" parameter: 0 task notification, 1 queue, 2 binary semaphore
+// "core" parameter: the waiter's core. The interrupt is allocated on core 0,
+//                   where setup runs, so 0 is same-core and 1 cross-core.
+// "load" parameter: 0 idle system, 1 the saturated dualcore workload running
+//                   on both cores in the background
+//
+// Only the GPTimer driver and FreeRTOS are involved, so the benchmark also
+// runs under QEMU's timer group emulation; latencies there describe the
+// emulator, not the chip.
+
+#define IRQ_EVENTS 500
+#define IRQ_TIMER_HZ 10000000  // 100 ns per count
+#define IRQ_NS_PER_COUNT (1000000000 / IRQ_TIMER_HZ)
+#define IRQ_ALARM_DELAY (20 * (IRQ_TIMER_HZ / 1000000))  // counts from arming to the event: 20 μs
+#define IRQ_EVENT_TIMEOUT_MS 100
+// Above the background workload so arming is never delayed by it, below the
+// waiter so the waiter's wake-up is what gets measured
+#define IRQ_MEASURER_PRIORITY (DUAL_CORE_HELPER_PRIORITY - 1)
+
+enum { WAKE_NOTIFY, WAKE_QUEUE, WAKE_SEMAPHORE, WAKE_COUNT };
+
+typedef struct {
+    int wake;
+    gptimer_handle_t timer;
+    bool enabled;
+    bool started;
+    bool load;
+    TaskHandle_t measurer;
+    TaskHandle_t waiter;
+    QueueHandle_t queue;
+    SemaphoreHandle_t semaphore;
+    UBaseType_t saved_priority;
+    uint64_t alarm;               // counter value of the pending alarm
+    volatile uint64_t isr_count;  // counter value read by the ISR
+    uint32_t timeouts;            // runs whose event did not reach the waiter in time
+    dual_core_helper_t helper;
+    bench_hist_t entry;           // ns, written by the waiter only
+    bench_hist_t to_task;
+    bench_hist_t total;
+} irq_run_t;
+
+static bool IRAM_ATTR irq_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *event, void *arg) {
+    irq_run_t *run = arg;
+    uint64_t count;
+    BaseType_t woken = pdFALSE;
+
+    gptimer_get_raw_count(timer, &count);
+    run->isr_count = count;
+    switch(run->wake) {
+        case WAKE_NOTIFY:
+            vTaskNotifyGiveFromISR(run->waiter, &woken);
+            break;
+        case WAKE_QUEUE:
+            xQueueSendFromISR(run->queue, &count, &woken);
+            break;
+        default:
+            xSemaphoreGiveFromISR(run->semaphore, &woken);
+            break;
+    }
+    return woken == pdTRUE;  // the driver yields on return if the waiter outranks the interrupted task
+}
+
+static void irq_wait(irq_run_t *run) {
+    uint64_t count;
+
+    switch(run->wake) {
+        case WAKE_NOTIFY:
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            break;
+        case WAKE_QUEUE:
+            xQueueReceive(run->queue, &count, portMAX_DELAY);
+            break;
+        default:
+            xSemaphoreTake(run->semaphore, portMAX_DELAY);
+            break;
+    }
+}
+
+// Teardown's one wake-up of the waiter, from task context
+static void irq_wake(void *arg) {
+    irq_run_t *run = arg;
+    uint64_t count = 0;
+
+    switch(run->wake) {
+        case WAKE_NOTIFY: xTaskNotifyGive(run->waiter); break;
+        case WAKE_QUEUE: xQueueSend(run->queue, &count, portMAX_DELAY); break;
+        default: xSemaphoreGive(run->semaphore); break;
+    }
+}
+
+// Teardown sets `stop` and wakes the waiter once through irq_wake()
+static void irq_waiter_task(void *parameter) {
+    irq_run_t *run = parameter;
+
+    for(;;) {
+        irq_wait(run);
+        if(atomic_load_explicit(&run->helper.stop, memory_order_acquire)) {
+            break;
+        }
+        uint64_t now;
+        gptimer_get_raw_count(run->timer, &now);
+        uint64_t isr = run->isr_count;
+        bench_hist_record(&run->entry, (uint32_t)(isr - run->alarm) * IRQ_NS_PER_COUNT);
+        bench_hist_record(&run->to_task, (uint32_t)(now - isr) * IRQ_NS_PER_COUNT);
+        bench_hist_record(&run->total, (uint32_t)(now - run->alarm) * IRQ_NS_PER_COUNT);
+        xTaskNotifyGive(run->measurer);
+    }
+
+    dual_core_helper_exit(&run->helper);
+}
+
+static void irq_teardown(bench_case_t *c);
+
+static bool irq_setup(bench_case_t *c) {
+    if(c->values[0] < 0 || c->values[0] >= WAKE_COUNT || c->values[1] < 0 || c->values[1] > 1 ||
+       c->values[2] < 0 || c->values[2] > 1) {
+        return false;
+    }
+
+    irq_run_t *run = heap_caps_calloc(1, sizeof(irq_run_t), MALLOC_CAP_INTERNAL);
+    if(run == NULL) {
+        return false;
+    }
+    run->wake = c->values[0];
+    run->measurer = xTaskGetCurrentTaskHandle();
+    run->saved_priority = uxTaskPriorityGet(NULL);
+    bench_hist_reset(&run->entry);
+    bench_hist_reset(&run->to_task);
+    bench_hist_reset(&run->total);
+    c->state = run;
+
+    bool ok = true;
+    if(run->wake == WAKE_QUEUE) {
+        run->queue = xQueueCreate(1, sizeof(uint64_t));
+        ok = run->queue != NULL;
+    } else if(run->wake == WAKE_SEMAPHORE) {
+        run->semaphore = xSemaphoreCreateBinary();
+        ok = run->semaphore != NULL;
+    }
+
+    // Free-running counter; each run moves the alarm ahead of it
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = IRQ_TIMER_HZ,
+    };
+    gptimer_event_callbacks_t callbacks = { .on_alarm = irq_alarm };
+    ok = ok && gptimer_new_timer(&timer_config, &run->timer) == ESP_OK;
+    ok = ok && gptimer_register_event_callbacks(run->timer, &callbacks, run) == ESP_OK;
+    ok = ok && (run->enabled = gptimer_enable(run->timer) == ESP_OK);
+    ok = ok && (run->started = gptimer_start(run->timer) == ESP_OK);
+
+    if(ok) {
+        ok = dual_core_helper_start(&run->helper, irq_waiter_task, "IrqWaiter", 2048, run, c->values[1],
+                                    &run->waiter);
+    }
+    if(ok && run->saved_priority < IRQ_MEASURER_PRIORITY) {
+        vTaskPrioritySet(NULL, IRQ_MEASURER_PRIORITY);
+    }
+    if(ok && c->values[2]) {
+        ok = run->load = dual_core_load_start();
+    }
+    if(!ok) {
+        irq_teardown(c);
+        return false;
+    }
+
+    c->elements = 1;
+    c->config.warmup_runs = 16;
+    c->config.min_runs = IRQ_EVENTS;
+    c->config.max_runs = IRQ_EVENTS;
+    c->config.target_ci = 1.0;  // a fixed sample count: the spread is the result
+    return true;
+}
+
+static void irq_run(bench_case_t *c) {
+    irq_run_t *run = c->state;
+    uint64_t now;
+
+    ulTaskNotifyTake(pdTRUE, 0);  // a late notification from a run that timed out
+    gptimer_get_raw_count(run->timer, &now);
+    run->alarm = now + IRQ_ALARM_DELAY;
+    gptimer_alarm_config_t alarm = { .alarm_count = run->alarm };
+    gptimer_set_alarm_action(run->timer, &alarm);
+    if(ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IRQ_EVENT_TIMEOUT_MS)) == 0) {
+        run->timeouts++;
+    }
+}
+
+static void irq_teardown(bench_case_t *c) {
+    irq_run_t *run = c->state;
+
+    if(run->load) {
+        dual_core_load_stop();
+    }
+    dual_core_helper_join(&run->helper, irq_wake, run);
+    vTaskPrioritySet(NULL, run->saved_priority);
+
+    if(run->started) {
+        gptimer_stop(run->timer);
+    }
+    if(run->enabled) {
+        gptimer_disable(run->timer);
+    }
+    if(run->timer) {
+        gptimer_del_timer(run->timer);
+    }
+    if(run->queue) {
+        vQueueDelete(run->queue);
+    }
+    if(run->semaphore) {
+        vSemaphoreDelete(run->semaphore);
+    }
+
+    char params[48];
+    snprintf(params, sizeof(params), "wake=%ld core=%ld load=%ld", (long)c->values[0], (long)c->values[1],
+             (long)c->values[2]);
+    if(run->total.count > 0) {
+        char label[80];
+        snprintf(label, sizeof(label), "    alarm to ISR (%s)", params);
+        bench_hist_print(label, &run->entry, "ns");
+        snprintf(label, sizeof(label), "    ISR to task (%s)", params);
+        bench_hist_print(label, &run->to_task, "ns");
+        snprintf(label, sizeof(label), "    alarm to task (%s)", params);
+        bench_hist_print(label, &run->total, "ns");
+        bench_hist_report("dualcore", "irq_entry", params, "ns", &run->entry);
+        bench_hist_report("dualcore", "irq_to_task", params, "ns", &run->to_task);
+        bench_hist_report("dualcore", "irq_latency", params, "ns", &run->total);
+    }
+    if(run->timeouts > 0) {
+        printf("    %lu events timed out after %d ms (%s)\n", (unsigned long)run->timeouts, IRQ_EVENT_TIMEOUT_MS,
+               params);
+    }
+    heap_caps_free(run);
+}
+
+BENCH_DEFINE(dualcore_irq_latency, "dualcore", "irq_latency", irq_setup, irq_run, irq_teardown,
+             BENCH_PARAM("wake", WAKE_NOTIFY, WAKE_QUEUE, WAKE_SEMAPHORE),
+             BENCH_PARAM("core", 0, 1),
+             BENCH_PARAM("load", 0, 1))
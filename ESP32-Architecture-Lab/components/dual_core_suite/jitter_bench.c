@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+#include "bench.h"
+#include "dual_core_private.h"
+
+// Periodic release jitter. The measuring task on core 0 runs a control-loop
+// style body of JITTER_WORK_US every period; each timed run waits for one
+// release and does the work, so the run statistics are the interval between
+// releases. The release error -- how far each release is from the ideal grid
+// start + k * period -- goes into a histogram reported as
+// dualcore/jitter_error_p50 ... _max at teardown. Methods that drift show an
+// error that keeps growing. Releases a method skips (coalesced timer
+// notifications, periodic_wait() overruns) are counted as missed and do not
+// shift the grid.
+//
+// "method" parameter:
+//   0 vTaskDelay(period)       sleeps a period after the body: drifts by the
+//                              body's run time plus tick rounding
+//   1 vTaskDelayUntil          absolute tick deadlines: no drift, tick resolution
+//   2 esp_timer periodic       callback in the esp_timer task notifies the loop
+//   3 periodic_wait()          absolute esp_timer deadlines, sleep then spin
+//
+// "period_us" below one tick is skipped for the tick-based methods. The "hz"
+// axis only records configTICK_RATE_HZ so results from a 1000 Hz build (see
+// bench-suite/sdkconfig.defaults.1000hz) do not merge with 100 Hz ones.
+
+#define JITTER_RELEASES 200
+#define JITTER_WORK_US 200
+#define TICK_US (1000000 / configTICK_RATE_HZ)
+
+enum { JITTER_DELAY, JITTER_DELAY_UNTIL, JITTER_ESP_TIMER, JITTER_PERIODIC, JITTER_METHOD_COUNT };
+
+typedef struct {
+    int method;
+    uint32_t period_us;
+    TickType_t period_ticks;
+    TaskHandle_t task;
+    esp_timer_handle_t timer;
+    int64_t start;             // ideal release 0, esp_timer μs
+    uint32_t releases;
+    uint32_t missed;           // grid slots without a release
+    TickType_t last_wake;      // vTaskDelayUntil
+    periodic_t periodic;
+    uint32_t early;            // releases before their ideal time (recorded as 0)
+    bench_hist_t error;        // release error, μs
+} jitter_run_t;
+
+static void jitter_timer_callback(void *arg) {
+    jitter_run_t *run = arg;
+    xTaskNotifyGive(run->task);
+}
+
+static void busy_wait_us(uint32_t us) {
+    int64_t end = esp_timer_get_time() + us;
+    while(esp_timer_get_time() < end) {
+    }
+}
+
+static void jitter_teardown(bench_case_t *c);
+
+static bool jitter_setup(bench_case_t *c) {
+    int32_t method = c->values[0];
+    int32_t period_us = c->values[1];
+    if(method < 0 || method >= JITTER_METHOD_COUNT || period_us <= JITTER_WORK_US ||
+       c->values[2] != configTICK_RATE_HZ) {
+        return false;
+    }
+    if((method == JITTER_DELAY || method == JITTER_DELAY_UNTIL) && period_us % TICK_US != 0) {
+        return false;  // not a whole number of ticks
+    }
+
+    jitter_run_t *run = heap_caps_calloc(1, sizeof(jitter_run_t), MALLOC_CAP_INTERNAL);
+    if(run == NULL) {
+        return false;
+    }
+    run->method = method;
+    run->period_us = period_us;
+    run->period_ticks = period_us / TICK_US;
+    run->task = xTaskGetCurrentTaskHandle();
+    bench_hist_reset(&run->error);
+    c->state = run;
+
+    if(method == JITTER_ESP_TIMER) {
+        esp_timer_create_args_t args = { .callback = jitter_timer_callback, .arg = run, .name = "jitter" };
+        if(esp_timer_create(&args, &run->timer) != ESP_OK) {
+            jitter_teardown(c);
+            return false;
+        }
+        ulTaskNotifyTake(pdTRUE, 0);  // drop any stale notification
+    }
+
+    c->elements = 1;
+    c->config.warmup_runs = 0;  // the first release anchors the grid
+    c->config.min_runs = JITTER_RELEASES;
+    c->config.max_runs = JITTER_RELEASES;
+    c->config.target_ci = 1.0;  // a fixed sample count: the spread is the result
+    return true;
+}
+
+// Wait for the next release and return its esp_timer time
+static int64_t wait_release(jitter_run_t *run) {
+    switch(run->method) {
+        case JITTER_DELAY:
+            vTaskDelay(run->period_ticks);
+            break;
+        case JITTER_DELAY_UNTIL:
+            vTaskDelayUntil(&run->last_wake, run->period_ticks);
+            break;
+        case JITTER_ESP_TIMER:
+            run->missed += ulTaskNotifyTake(pdTRUE, portMAX_DELAY) - 1;
+            break;
+        default:
+            periodic_wait(&run->periodic);
+            run->missed = run->periodic.overruns;
+            break;
+    }
+    return esp_timer_get_time();
+}
+
+static void jitter_run(bench_case_t *c) {
+    jitter_run_t *run = c->state;
+
+    if(run->releases == 0) {
+        // Anchor the grid: align to a tick for the tick-based methods, then
+        // start the timer or the deadline sequence from here
+        vTaskDelay(1);
+        run->last_wake = xTaskGetTickCount();
+        run->start = esp_timer_get_time();
+        if(run->method == JITTER_ESP_TIMER) {
+            esp_timer_start_periodic(run->timer, run->period_us);
+        } else if(run->method == JITTER_PERIODIC) {
+            periodic_start(&run->periodic, run->period_us);
+        }
+    }
+
+    int64_t release = wait_release(run);
+    int64_t slot = run->releases + run->missed + 1;
+    int64_t error = release - (run->start + slot * run->period_us);
+    if(error < 0) {
+        run->early++;
+        error = 0;
+    }
+    bench_hist_record(&run->error, (uint32_t)error);
+    run->releases++;
+
+    busy_wait_us(JITTER_WORK_US);
+}
+
+static void jitter_teardown(bench_case_t *c) {
+    jitter_run_t *run = c->state;
+
+    if(run->timer) {
+        esp_timer_stop(run->timer);
+        esp_timer_delete(run->timer);
+        ulTaskNotifyTake(pdTRUE, 0);
+    }
+    if(run->releases > 0) {
+        char params[64];
+        char label[96];
+        snprintf(params, sizeof(params), "method=%d period_us=%lu hz=%d", run->method,
+                 (unsigned long)run->period_us, configTICK_RATE_HZ);
+        snprintf(label, sizeof(label), "    release error (%s)", params);
+        bench_hist_print(label, &run->error, "μs");
+        if(run->early > 0 || run->missed > 0) {
+            printf("    %lu releases early (counted as 0), %lu missed\n", (unsigned long)run->early,
+                   (unsigned long)run->missed);
+        }
+        bench_hist_report("dualcore", "jitter_error", params, "us", &run->error);
+    }
+    heap_caps_free(run);
+}
+
+BENCH_DEFINE(dualcore_jitter, "dualcore", "jitter", jitter_setup, jitter_run, jitter_teardown,
+             BENCH_PARAM("method", JITTER_DELAY, JITTER_DELAY_UNTIL, JITTER_ESP_TIMER, JITTER_PERIODIC),
+             BENCH_PARAM("period_us", 500, 1000, 10000),
+             BENCH_PARAM("hz", configTICK_RATE_HZ))
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <math.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_heap_caps.h>
+#include "bench.h"
+#include "job_pool.h"
+#include "dual_core_private.h"
+
+// Job placement policies under uneven load. Each timed run submits JOB_COUNT
+// jobs modelled on the dual-core workload's two kinds of work: protocol-style
+// checksum jobs, homed on core 0, and float jobs, homed on core 1. The
+// measuring task submits them all, then waits for the group, so cycles/run
+// is the makespan of the batch and cycles/element the cost per job.
+//
+// "policy" parameter: 0 static pinning (each core runs its own jobs, as
+//                     dual_core_test does), 1 one shared queue, 2 work stealing
+// "skew" parameter:   0 both kinds the same size, 1 bursty: checksum jobs
+//                     JOB_SKEW_FACTOR times larger and every JOB_OUTLIER_EVERY-th
+//                     job JOB_OUTLIER_FACTOR times larger again, so core 0's
+//                     share of the work is far above half
+//
+// Per-core job counts, steals and core 1's share of the work are printed at
+// teardown.
+
+#define JOB_COUNT 64
+#define JOB_BASE_UNITS 2000        // inner-loop iterations of an unskewed job
+#define JOB_SKEW_FACTOR 3
+#define JOB_OUTLIER_EVERY 8
+#define JOB_OUTLIER_FACTOR 4
+
+typedef struct {
+    uint32_t units;
+    bool checksum;  // checksum kind (core 0) or float kind (core 1)
+    uint32_t core;  // where it ran last
+    float result;
+} job_work_t;
+
+typedef struct {
+    job_pool_t *pool;
+    job_group_t group;
+    job_work_t work[JOB_COUNT];
+    uint32_t runs;
+} job_run_t;
+
+static void checksum_job(void *arg) {
+    job_work_t *work = arg;
+    uint32_t checksum = 0;
+    for(uint32_t j = 0; j < work->units; j++) {
+        checksum += j * 997;
+    }
+    work->result = checksum;
+    work->core = xPortGetCoreID();
+}
+
+static void float_job(void *arg) {
+    job_work_t *work = arg;
+    float result = 0.0f;
+    for(uint32_t j = 0; j < work->units; j++) {
+        result += sqrtf(j * 1.7f);
+    }
+    work->result = result;
+    work->core = xPortGetCoreID();
+}
+
+static void job_teardown(bench_case_t *c);
+
+static bool job_setup(bench_case_t *c) {
+    if(c->values[0] < JOB_POOL_STATIC || c->values[0] > JOB_POOL_STEAL || c->values[1] < 0 || c->values[1] > 1) {
+        return false;
+    }
+
+    job_run_t *run = heap_caps_calloc(1, sizeof(job_run_t), MALLOC_CAP_INTERNAL);
+    if(run == NULL) {
+        return false;
+    }
+    c->state = run;
+
+    bool skew = c->values[1];
+    for(uint32_t i = 0; i < JOB_COUNT; i++) {
+        job_work_t *work = &run->work[i];
+        work->checksum = i % 2 == 0;
+        work->units = JOB_BASE_UNITS;
+        if(skew && work->checksum) {
+            work->units *= JOB_SKEW_FACTOR;
+        }
+        if(skew && i % JOB_OUTLIER_EVERY == 0) {
+            work->units *= JOB_OUTLIER_FACTOR;
+        }
+    }
+
+    // Workers at the measuring task's priority: core 0's worker does not
+    // preempt the submission, so each run queues the whole batch as a burst
+    // and core 0 only starts on it once the measuring task waits
+    job_group_init(&run->group);
+    run->pool = job_pool_create((job_pool_policy_t)c->values[0], uxTaskPriorityGet(NULL), JOB_COUNT);
+    if(run->pool == NULL) {
+        job_teardown(c);
+        return false;
+    }
+
+    c->elements = JOB_COUNT;
+    return true;
+}
+
+static void job_run(bench_case_t *c) {
+    job_run_t *run = c->state;
+
+    for(uint32_t i = 0; i < JOB_COUNT; i++) {
+        job_work_t *work = &run->work[i];
+        job_pool_submit(run->pool, &run->group, work->checksum ? 0 : 1, work->checksum ? checksum_job : float_job,
+                        work);
+    }
+    job_group_wait(&run->group);
+    run->runs++;
+}
+
+static void job_teardown(bench_case_t *c) {
+    job_run_t *run = c->state;
+
+    if(run->pool && run->runs > 0) {
+        job_deque_t *deques = run->pool->deques;
+        printf("    per run: core 0 ran %.1f jobs (%.1f stolen), core 1 ran %.1f (%.1f stolen)\n",
+               (double)deques[0].executed / run->runs, (double)deques[0].stolen / run->runs,
+               (double)deques[1].executed / run->runs, (double)deques[1].stolen / run->runs);
+
+        uint32_t units[2] = { 0 };
+        for(uint32_t i = 0; i < JOB_COUNT; i++) {
+            units[run->work[i].core] += run->work[i].units;
+        }
+        printf("    core 1 did %.0f%% of the work in the last run\n", 100.0 * units[1] / (units[0] + units[1]));
+    }
+    job_pool_delete(run->pool);
+    heap_caps_free(run);
+}
+
+BENCH_DEFINE(dualcore_job_pool, "dualcore", "job_pool", job_setup, job_run, job_teardown,
+             BENCH_PARAM("policy", JOB_POOL_STATIC, JOB_POOL_SHARED, JOB_POOL_STEAL),
+             BENCH_PARAM("skew", 0, 1))
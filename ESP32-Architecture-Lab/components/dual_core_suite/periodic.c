@@ -0,0 +1,54 @@
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#include "dual_core_private.h"
+
+#define TICK_US (1000000 / configTICK_RATE_HZ)
+
+void idle_yield_reset(idle_yield_t *idle) {
+    idle->due = esp_timer_get_time() + IDLE_YIELD_MS * 1000LL;
+}
+
+bool idle_yield_check(idle_yield_t *idle) {
+    if(esp_timer_get_time() < idle->due) {
+        return false;
+    }
+    vTaskDelay(1);
+    idle_yield_reset(idle);
+    return true;
+}
+
+void periodic_start(periodic_t *periodic, uint32_t period_us) {
+    int64_t now = esp_timer_get_time();
+    periodic->period_us = period_us;
+    periodic->overruns = 0;
+    periodic->next = now + period_us;
+    idle_yield_reset(&periodic->idle);
+}
+
+uint32_t periodic_wait(periodic_t *periodic) {
+    // vTaskDelay(n) returns after n tick interrupts, the first of which may
+    // come at once, so it sleeps between n - 1 and n ticks: keep one tick in
+    // hand and spin the rest
+    int64_t now;
+    int64_t remaining = periodic->next - esp_timer_get_time();
+    if(remaining > 2 * TICK_US) {
+        vTaskDelay(remaining / TICK_US - 1);
+        idle_yield_reset(&periodic->idle);
+    } else {
+        idle_yield_check(&periodic->idle);  // the releases it sleeps through are overruns below
+    }
+    
+    while((now = esp_timer_get_time()) < periodic->next) {
+    }
+    
+    uint32_t late = now - periodic->next;
+    periodic->next += periodic->period_us;
+    // A body that ran past whole periods skips those releases rather than
+    // running back to back to catch up
+    while(periodic->next <= now) {
+        periodic->next += periodic->period_us;
+        periodic->overruns++;
+    }
+    return late;
+}
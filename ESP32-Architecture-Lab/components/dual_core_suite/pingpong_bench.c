@@ -0,0 +1,252 @@
+#include <stdatomic.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/event_groups.h>
+#include <freertos/stream_buffer.h>
+#include <freertos/message_buffer.h>
+#include <esp_ipc.h>
+#include <esp_heap_caps.h>
+#include "bench.h"
+#include "dual_core_private.h"
+
+// Inter-core round trip per signalling primitive. The measuring task on
+// core 0 sends a ping and waits for the pong from a helper task on core 1;
+// each timed run is a single round trip, so the run statistics (min, median,
+// p95, p99, max over PINGPONG_ROUND_TRIPS runs) are the latency distribution
+// of that primitive. Messages carry a 4-byte sequence number where the
+// primitive carries data.
+//
+// "primitive" parameter: 0 queue, 1 task notification, 2 binary semaphore,
+// 3 event group, 4 stream buffer, 5 message buffer, 6 esp_ipc_call_blocking,
+// 7 spin-polling on shared memory
+
+#define PINGPONG_ROUND_TRIPS 1000
+#define PING_BIT BIT0
+#define PONG_BIT BIT1
+
+enum {
+    PP_QUEUE,
+    PP_NOTIFY,
+    PP_SEMAPHORE,
+    PP_EVENT_GROUP,
+    PP_STREAM_BUFFER,
+    PP_MESSAGE_BUFFER,
+    PP_IPC_CALL,
+    PP_SPIN,
+    PP_COUNT
+};
+
+typedef struct {
+    int primitive;
+    uint32_t seq;
+    TaskHandle_t pinger;
+    TaskHandle_t ponger;
+    QueueHandle_t ping_queue;            // queue
+    QueueHandle_t pong_queue;
+    SemaphoreHandle_t ping_sem;          // binary semaphore
+    SemaphoreHandle_t pong_sem;
+    EventGroupHandle_t events;           // event group
+    StreamBufferHandle_t ping_stream;    // stream or message buffer: same API, the
+                                         // handle knows which framing it uses
+    StreamBufferHandle_t pong_stream;
+    _Alignas(32) atomic_uint ping_seq;   // spin-polling, one line per direction
+    _Alignas(32) atomic_uint pong_seq;
+    dual_core_helper_t helper;
+} pingpong_run_t;
+
+// Runs in core 1's IPC task; esp_ipc_call_blocking() returns once it has
+static void ipc_pong(void *arg) {
+    pingpong_run_t *run = arg;
+    atomic_store_explicit(&run->pong_seq, run->seq, memory_order_release);
+}
+
+// Core 0: one ping, then wait for the matching pong
+static void ping(pingpong_run_t *run) {
+    uint32_t seq = ++run->seq;
+    uint32_t reply;
+
+    switch(run->primitive) {
+        case PP_QUEUE:
+            xQueueSend(run->ping_queue, &seq, portMAX_DELAY);
+            xQueueReceive(run->pong_queue, &reply, portMAX_DELAY);
+            break;
+        case PP_NOTIFY:
+            xTaskNotifyGive(run->ponger);
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            break;
+        case PP_SEMAPHORE:
+            xSemaphoreGive(run->ping_sem);
+            xSemaphoreTake(run->pong_sem, portMAX_DELAY);
+            break;
+        case PP_EVENT_GROUP:
+            xEventGroupSetBits(run->events, PING_BIT);
+            xEventGroupWaitBits(run->events, PONG_BIT, pdTRUE, pdTRUE, portMAX_DELAY);
+            break;
+        case PP_STREAM_BUFFER:
+        case PP_MESSAGE_BUFFER:
+            xStreamBufferSend(run->ping_stream, &seq, sizeof(seq), portMAX_DELAY);
+            xStreamBufferReceive(run->pong_stream, &reply, sizeof(reply), portMAX_DELAY);
+            break;
+        case PP_IPC_CALL:
+            esp_ipc_call_blocking(DUAL_CORE_HELPER_CORE, ipc_pong, run);
+            break;
+        default:
+            atomic_store_explicit(&run->ping_seq, seq, memory_order_release);
+            while(atomic_load_explicit(&run->pong_seq, memory_order_acquire) != seq) {
+            }
+            break;
+    }
+}
+
+// Core 1: wait for one ping and answer it
+static void pong(pingpong_run_t *run) {
+    uint32_t seq;
+
+    switch(run->primitive) {
+        case PP_QUEUE:
+            xQueueReceive(run->ping_queue, &seq, portMAX_DELAY);
+            xQueueSend(run->pong_queue, &seq, portMAX_DELAY);
+            break;
+        case PP_NOTIFY:
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            xTaskNotifyGive(run->pinger);
+            break;
+        case PP_SEMAPHORE:
+            xSemaphoreTake(run->ping_sem, portMAX_DELAY);
+            xSemaphoreGive(run->pong_sem);
+            break;
+        case PP_EVENT_GROUP:
+            xEventGroupWaitBits(run->events, PING_BIT, pdTRUE, pdTRUE, portMAX_DELAY);
+            xEventGroupSetBits(run->events, PONG_BIT);
+            break;
+        case PP_STREAM_BUFFER:
+        case PP_MESSAGE_BUFFER:
+            xStreamBufferReceive(run->ping_stream, &seq, sizeof(seq), portMAX_DELAY);
+            xStreamBufferSend(run->pong_stream, &seq, sizeof(seq), portMAX_DELAY);
+            break;
+        default: {
+            uint32_t last = atomic_load_explicit(&run->pong_seq, memory_order_relaxed);
+            while((seq = atomic_load_explicit(&run->ping_seq, memory_order_acquire)) == last) {
+            }
+            atomic_store_explicit(&run->pong_seq, seq, memory_order_release);
+            break;
+        }
+    }
+}
+
+// Teardown sets `stop` and sends one last ping, so a helper blocked in any
+// primitive wakes up, answers and exits
+static void pong_task(void *parameter) {
+    pingpong_run_t *run = parameter;
+
+    do {
+        pong(run);
+    } while(!atomic_load_explicit(&run->helper.stop, memory_order_acquire));
+
+    dual_core_helper_exit(&run->helper);
+}
+
+static void pingpong_wake(void *arg) {
+    ping(arg);
+}
+
+static void pingpong_teardown(bench_case_t *c);
+
+static bool pingpong_setup(bench_case_t *c) {
+    if(c->values[0] < 0 || c->values[0] >= PP_COUNT) {
+        return false;
+    }
+
+    pingpong_run_t *run = heap_caps_aligned_calloc(32, 1, sizeof(pingpong_run_t), MALLOC_CAP_INTERNAL);
+    if(run == NULL) {
+        return false;
+    }
+    run->primitive = c->values[0];
+    run->pinger = xTaskGetCurrentTaskHandle();
+    c->state = run;
+
+    bool ok = true;
+    switch(run->primitive) {
+        case PP_QUEUE:
+            run->ping_queue = xQueueCreate(1, sizeof(uint32_t));
+            run->pong_queue = xQueueCreate(1, sizeof(uint32_t));
+            ok = run->ping_queue && run->pong_queue;
+            break;
+        case PP_SEMAPHORE:
+            run->ping_sem = xSemaphoreCreateBinary();
+            run->pong_sem = xSemaphoreCreateBinary();
+            ok = run->ping_sem && run->pong_sem;
+            break;
+        case PP_EVENT_GROUP:
+            run->events = xEventGroupCreate();
+            ok = run->events != NULL;
+            break;
+        case PP_STREAM_BUFFER:
+            run->ping_stream = xStreamBufferCreate(4 * sizeof(uint32_t), sizeof(uint32_t));
+            run->pong_stream = xStreamBufferCreate(4 * sizeof(uint32_t), sizeof(uint32_t));
+            ok = run->ping_stream && run->pong_stream;
+            break;
+        case PP_MESSAGE_BUFFER:
+            run->ping_stream = xMessageBufferCreate(4 * (sizeof(uint32_t) + sizeof(size_t)));
+            run->pong_stream = xMessageBufferCreate(4 * (sizeof(uint32_t) + sizeof(size_t)));
+            ok = run->ping_stream && run->pong_stream;
+            break;
+        default:
+            break;
+    }
+
+    if(ok && run->primitive != PP_IPC_CALL) {
+        ok = dual_core_helper_start(&run->helper, pong_task, "PingPong", 2048, run,
+                                    DUAL_CORE_HELPER_CORE, &run->ponger);
+    }
+    if(!ok) {
+        pingpong_teardown(c);
+        return false;
+    }
+
+    c->elements = 1;
+    c->config.warmup_runs = 16;
+    c->config.min_runs = PINGPONG_ROUND_TRIPS;
+    c->config.max_runs = PINGPONG_ROUND_TRIPS;
+    c->config.target_ci = 1.0;  // a fixed sample count: the spread is the result, not noise
+    return true;
+}
+
+static void pingpong_run(bench_case_t *c) {
+    ping(c->state);
+}
+
+static void pingpong_teardown(bench_case_t *c) {
+    pingpong_run_t *run = c->state;
+
+    dual_core_helper_join(&run->helper, pingpong_wake, run);
+
+    if(run->ping_queue) {
+        vQueueDelete(run->ping_queue);
+    }
+    if(run->pong_queue) {
+        vQueueDelete(run->pong_queue);
+    }
+    if(run->ping_sem) {
+        vSemaphoreDelete(run->ping_sem);
+    }
+    if(run->pong_sem) {
+        vSemaphoreDelete(run->pong_sem);
+    }
+    if(run->events) {
+        vEventGroupDelete(run->events);
+    }
+    if(run->ping_stream) {
+        vStreamBufferDelete(run->ping_stream);
+    }
+    if(run->pong_stream) {
+        vStreamBufferDelete(run->pong_stream);
+    }
+    heap_caps_free(run);
+}
+
+BENCH_DEFINE(dualcore_pingpong, "dualcore", "pingpong", pingpong_setup, pingpong_run, pingpong_teardown,
+             BENCH_PARAM("primitive", PP_QUEUE, PP_NOTIFY, PP_SEMAPHORE, PP_EVENT_GROUP, PP_STREAM_BUFFER,
+                         PP_MESSAGE_BUFFER, PP_IPC_CALL, PP_SPIN))
@@ -0,0 +1,321 @@
+#include <stdio.h>
+#include <stdatomic.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+#include "bench.h"
+#include "pipeline.h"
+#include "dual_core_private.h"
+
+typedef struct {
+    pipeline_t *pipeline;
+    pipeline_stage_config_t config;
+    QueueHandle_t input;               // NULL for the source
+    pipeline_stage_stats_t stats;
+} pipeline_stage_t;
+
+struct pipeline {
+    pipeline_stage_t stages[PIPELINE_MAX_STAGES];
+    uint32_t count;
+    QueueHandle_t free_items;          // the item pool
+    esp_timer_handle_t release;        // notifies the source every period, if it has one
+    TaskHandle_t source;
+    uint8_t *items;
+    bench_hist_t latency;              // written by the sink only
+    uint32_t seq;                      // written by the source only
+    atomic_bool stop;
+    atomic_int running;                // live stage tasks
+};
+
+// Hand `item` to the stage after `stage`. Returns false when the pipeline is
+// stopping or the item was dropped; the item is then back in the pool.
+static bool pass_on(pipeline_stage_t *stage, pipeline_item_t *item) {
+    pipeline_t *pipeline = stage->pipeline;
+    pipeline_stage_t *next = stage + 1;
+
+    if(next->config.policy == PIPELINE_DROP) {
+        if(xQueueSend(next->input, &item, 0) != pdTRUE) {
+            next->stats.dropped++;  // only this task sends to `next`, so only it writes `dropped`
+            xQueueSend(pipeline->free_items, &item, 0);
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t start = esp_timer_get_time();
+    while(xQueueSend(next->input, &item, pdMS_TO_TICKS(PIPELINE_POLL_MS)) != pdTRUE) {
+        if(atomic_load(&pipeline->stop)) {
+            xQueueSend(pipeline->free_items, &item, 0);
+            return false;
+        }
+    }
+    stage->stats.stall_us += esp_timer_get_time() - start;
+    return true;
+}
+
+// Run the stage function on one item and pass it on; the sink frees it
+static void process(pipeline_stage_t *stage, pipeline_item_t *item) {
+    pipeline_t *pipeline = stage->pipeline;
+
+    uint64_t start = esp_timer_get_time();
+    bool keep = stage->config.fn(stage->config.ctx, item);
+    uint64_t end = esp_timer_get_time();
+    stage->stats.busy_us += end - start;
+    stage->stats.items++;
+
+    if(!keep) {
+        stage->stats.filtered++;
+        xQueueSend(pipeline->free_items, &item, 0);
+    } else if(stage == &pipeline->stages[pipeline->count - 1]) {
+        bench_hist_record(&pipeline->latency, (uint32_t)(end - item->created_us));
+        xQueueSend(pipeline->free_items, &item, 0);
+    } else {
+        pass_on(stage, item);
+    }
+}
+
+// Take the next item from `queue`, waiting up to PIPELINE_POLL_MS. A stage
+// that always finds one waiting never blocks, so it yields through `idle`.
+static bool receive_item(QueueHandle_t queue, pipeline_item_t **item, idle_yield_t *idle) {
+    idle_yield_check(idle);
+    if(xQueueReceive(queue, item, 0) == pdTRUE) {
+        return true;
+    }
+    idle_yield_reset(idle);  // about to block
+    return xQueueReceive(queue, item, pdMS_TO_TICKS(PIPELINE_POLL_MS)) == pdTRUE;
+}
+
+// esp_timer callback: release the source
+static void source_release(void *arg) {
+    pipeline_t *pipeline = arg;
+    xTaskNotifyGive(pipeline->source);
+}
+
+static void source_task(void *parameter) {
+    pipeline_stage_t *stage = parameter;
+    pipeline_t *pipeline = stage->pipeline;
+    idle_yield_t idle;
+
+    idle_yield_reset(&idle);
+    while(!atomic_load(&pipeline->stop)) {
+        pipeline_item_t *item;
+        bool received;
+        if(stage->config.period_us > 0) {
+            // Blocked until the next release, so the stages sharing this
+            // core run in between. Releases that came while the source was
+            // still busy arrive as one notification and are skipped.
+            uint32_t releases = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PIPELINE_POLL_MS));
+            if(releases == 0) {
+                continue;
+            }
+            stage->stats.dropped += releases - 1;
+            received = xQueueReceive(pipeline->free_items, &item, pdMS_TO_TICKS(PIPELINE_POLL_MS)) == pdTRUE;
+        } else {
+            received = receive_item(pipeline->free_items, &item, &idle);
+        }
+        if(!received) {
+            continue;
+        }
+        item->seq = pipeline->seq++;
+        item->created_us = esp_timer_get_time();
+        process(stage, item);
+    }
+
+    atomic_fetch_sub(&pipeline->running, 1);
+    vTaskDelete(NULL);
+}
+
+static void stage_task(void *parameter) {
+    pipeline_stage_t *stage = parameter;
+    pipeline_t *pipeline = stage->pipeline;
+    idle_yield_t idle;
+
+    idle_yield_reset(&idle);
+    while(!atomic_load(&pipeline->stop)) {
+        pipeline_item_t *item;
+        if(!receive_item(stage->input, &item, &idle)) {
+            continue;
+        }
+        // Depth left behind this item: what the stage is falling behind by
+        uint32_t depth = uxQueueMessagesWaiting(stage->input);
+        stage->stats.occupancy_sum += depth;
+        if(depth > stage->stats.occupancy_max) {
+            stage->stats.occupancy_max = depth;
+        }
+        process(stage, item);
+    }
+
+    atomic_fetch_sub(&pipeline->running, 1);
+    vTaskDelete(NULL);
+}
+
+pipeline_t *pipeline_create(const pipeline_stage_config_t *stages, uint32_t count, uint32_t item_size) {
+    if(count < 2 || count > PIPELINE_MAX_STAGES) {
+        return NULL;
+    }
+    uint32_t pool_items = count;  // one held by each stage
+    for(uint32_t i = 0; i < count; i++) {
+        if(stages[i].fn == NULL || (i > 0 && stages[i].capacity == 0)) {
+            return NULL;
+        }
+        pool_items += i > 0 ? stages[i].capacity : 0;
+    }
+
+    pipeline_t *pipeline = heap_caps_calloc(1, sizeof(pipeline_t), MALLOC_CAP_INTERNAL);
+    if(pipeline == NULL) {
+        return NULL;
+    }
+    pipeline->count = count;
+    bench_hist_reset(&pipeline->latency);
+
+    // Item stride keeps every header 8-byte aligned for created_us
+    size_t stride = (sizeof(pipeline_item_t) + item_size + 7) & ~(size_t)7;
+    pipeline->items = heap_caps_calloc(pool_items, stride, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    pipeline->free_items = xQueueCreate(pool_items, sizeof(pipeline_item_t *));
+    bool ok = pipeline->items && pipeline->free_items;
+    for(uint32_t i = 0; ok && i < pool_items; i++) {
+        pipeline_item_t *item = (pipeline_item_t *)(pipeline->items + i * stride);
+        xQueueSend(pipeline->free_items, &item, 0);
+    }
+
+    for(uint32_t i = 0; ok && i < count; i++) {
+        pipeline_stage_t *stage = &pipeline->stages[i];
+        stage->pipeline = pipeline;
+        stage->config = stages[i];
+        if(i > 0) {
+            stage->input = xQueueCreate(stages[i].capacity, sizeof(pipeline_item_t *));
+            ok = stage->input != NULL;
+        }
+    }
+    if(ok && stages[0].period_us > 0) {
+        esp_timer_create_args_t args = { .callback = source_release, .arg = pipeline, .name = "pipeline" };
+        ok = esp_timer_create(&args, &pipeline->release) == ESP_OK;
+    }
+    if(!ok) {
+        pipeline_delete(pipeline);
+        return NULL;
+    }
+    return pipeline;
+}
+
+bool pipeline_start(pipeline_t *pipeline) {
+    atomic_store(&pipeline->stop, false);
+
+    // Downstream first, so the source never fills a channel nobody reads yet
+    for(int i = pipeline->count - 1; i >= 0; i--) {
+        pipeline_stage_t *stage = &pipeline->stages[i];
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "Pipe%s", stage->config.name ? stage->config.name : "Stage");
+        atomic_fetch_add(&pipeline->running, 1);
+        if(xTaskCreatePinnedToCore(i == 0 ? source_task : stage_task, name, 3072, stage,
+                                   stage->config.priority, i == 0 ? &pipeline->source : NULL,
+                                   stage->config.core) != pdPASS) {
+            atomic_fetch_sub(&pipeline->running, 1);
+            pipeline_stop(pipeline);
+            return false;
+        }
+    }
+    if(pipeline->release &&
+       esp_timer_start_periodic(pipeline->release, pipeline->stages[0].config.period_us) != ESP_OK) {
+        pipeline_stop(pipeline);
+        return false;
+    }
+    return true;
+}
+
+void pipeline_stop(pipeline_t *pipeline) {
+    if(pipeline->release) {
+        esp_timer_stop(pipeline->release);  // fails harmlessly when it was not started
+    }
+    atomic_store(&pipeline->stop, true);
+    while(atomic_load(&pipeline->running) != 0) {
+        vTaskDelay(1);
+    }
+    for(uint32_t i = 1; i < pipeline->count; i++) {
+        pipeline_item_t *item;
+        while(xQueueReceive(pipeline->stages[i].input, &item, 0) == pdTRUE) {
+            xQueueSend(pipeline->free_items, &item, 0);
+        }
+    }
+}
+
+void pipeline_delete(pipeline_t *pipeline) {
+    if(pipeline == NULL) {
+        return;
+    }
+    for(uint32_t i = 0; i < pipeline->count; i++) {
+        if(pipeline->stages[i].input) {
+            vQueueDelete(pipeline->stages[i].input);
+        }
+    }
+    if(pipeline->free_items) {
+        vQueueDelete(pipeline->free_items);
+    }
+    if(pipeline->release) {
+        esp_timer_delete(pipeline->release);
+    }
+    heap_caps_free(pipeline->items);
+    heap_caps_free(pipeline);
+}
+
+const pipeline_stage_stats_t *pipeline_stage_stats(const pipeline_t *pipeline, uint32_t stage) {
+    return stage < pipeline->count ? &pipeline->stages[stage].stats : NULL;
+}
+
+const bench_hist_t *pipeline_latency(const pipeline_t *pipeline) {
+    return &pipeline->latency;
+}
+
+uint32_t pipeline_report(const pipeline_t *pipeline, uint64_t elapsed_us, const char *params) {
+    uint32_t bottleneck = 0;
+    double seconds = elapsed_us / 1000000.0;
+    char stage_params[96];
+
+    printf("%-12s %5s %10s %7s %7s %11s %8s %8s\n", "Stage", "Core", "Items/s", "Busy", "Stalled",
+           "Occupancy", "Max", "Dropped");
+    for(uint32_t i = 0; i < pipeline->count; i++) {
+        const pipeline_stage_t *stage = &pipeline->stages[i];
+        const pipeline_stage_stats_t *stats = &stage->stats;
+        double throughput = seconds > 0 ? stats->items / seconds : 0.0;
+        double busy = elapsed_us ? 100.0 * stats->busy_us / elapsed_us : 0.0;
+        double stalled = elapsed_us ? 100.0 * stats->stall_us / elapsed_us : 0.0;
+        double occupancy = stats->items ? (double)stats->occupancy_sum / stats->items : 0.0;
+        if(stats->busy_us > pipeline->stages[bottleneck].stats.busy_us) {
+            bottleneck = i;
+        }
+
+        char core[8];
+        if(stage->config.core == tskNO_AFFINITY) {
+            snprintf(core, sizeof(core), "any");
+        } else {
+            snprintf(core, sizeof(core), "%d", (int)stage->config.core);
+        }
+        if(i == 0) {
+            printf("%-12s %5s %10.1f %6.1f%% %6.1f%% %11s %8s %8lu\n", stage->config.name, core, throughput,
+                   busy, stalled, "-", "-", (unsigned long)stats->dropped);
+        } else {
+            printf("%-12s %5s %10.1f %6.1f%% %6.1f%% %7.2f/%-3lu %8lu %8lu\n", stage->config.name, core,
+                   throughput, busy, stalled, occupancy, (unsigned long)stage->config.capacity,
+                   (unsigned long)stats->occupancy_max, (unsigned long)stats->dropped);
+        }
+
+        snprintf(stage_params, sizeof(stage_params), "stage=%s%s%s", stage->config.name,
+                 params ? " " : "", params ? params : "");
+        bench_report_metric("dualcore", "pipeline_throughput", stage_params, "items/s", throughput, true);
+        bench_report_metric("dualcore", "pipeline_busy", stage_params, "%", busy, false);
+        if(i > 0) {
+            bench_report_metric("dualcore", "pipeline_occupancy", stage_params, "items", occupancy, false);
+        }
+        bench_report_metric("dualcore", "pipeline_drops", stage_params, "items", stats->dropped, false);
+    }
+
+    if(pipeline->latency.count > 0) {
+        bench_hist_print("End-to-end latency", &pipeline->latency, "μs");
+        bench_hist_report("dualcore", "pipeline_latency", params, "us", &pipeline->latency);
+    }
+    printf("Bottleneck: %s (%.1f%% busy)\n", pipeline->stages[bottleneck].config.name,
+           elapsed_us ? 100.0 * pipeline->stages[bottleneck].stats.busy_us / elapsed_us : 0.0);
+    return bottleneck;
+}
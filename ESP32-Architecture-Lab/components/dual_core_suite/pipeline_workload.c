@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#include "bench.h"
+#include "pipeline.h"
+#include "dual_core_private.h"
+
+// The dual-core workload as the firmware is actually structured: the
+// protocol side (produce, parse) on core 0 and the application side
+// (transform, sink) on core 1, joined by bounded channels instead of a
+// single queue hop. The per-item work of parse and transform is the
+// workload's per-iteration work (1000 checksum steps, 500 square roots).
+
+#define PIPELINE_STAGE_PRIORITY 2
+// Above parse on core 0, so each release runs on time instead of at parse's
+// next time slice
+#define PIPELINE_SOURCE_PRIORITY 3
+// Above the stages, so the run ends on time even when a stage never blocks
+#define PIPELINE_RUNNER_PRIORITY 4
+#define PIPELINE_PAYLOAD 32
+#define PARSE_STEPS 1000
+#define TRANSFORM_STEPS 500
+
+typedef struct {
+    uint32_t checksum;
+    float result;
+} pipeline_payload_t;
+
+static bool produce_stage(void *ctx, pipeline_item_t *item) {
+    snprintf((char *)item->data, PIPELINE_PAYLOAD, "Hello from Core 0 #%lu", (unsigned long)item->seq);
+    return true;
+}
+
+// Protocol processing: checksum the message, then reuse its start for the result
+static bool parse_stage(void *ctx, pipeline_item_t *item) {
+    uint32_t checksum = 0;
+    for(int j = 0; j < PARSE_STEPS; j++) {
+        checksum += j * 997 + item->data[j % PIPELINE_PAYLOAD];
+    }
+    pipeline_payload_t *payload = (pipeline_payload_t *)item->data;
+    payload->checksum = checksum;
+    return true;
+}
+
+static bool transform_stage(void *ctx, pipeline_item_t *item) {
+    pipeline_payload_t *payload = (pipeline_payload_t *)item->data;
+    float result = 0.0f;
+    for(int j = 0; j < TRANSFORM_STEPS; j++) {
+        result += sqrtf(j * 1.7f);
+    }
+    payload->result = result + payload->checksum;
+    return true;
+}
+
+static bool sink_stage(void *ctx, pipeline_item_t *item) {
+    const pipeline_payload_t *payload = (const pipeline_payload_t *)item->data;
+    *(volatile float *)ctx = payload->result;
+    return true;
+}
+
+bool dual_core_pipeline_run(const dual_core_pipeline_config_t *config) {
+    static const dual_core_pipeline_config_t defaults = DUAL_CORE_PIPELINE_CONFIG_DEFAULT;
+    static volatile float sink;
+    if(config == NULL) {
+        config = &defaults;
+    }
+    if(config->duration_ms == 0 || config->period_us == 0 || config->capacity == 0) {
+        printf("Invalid pipeline configuration\n");
+        return false;
+    }
+
+    pipeline_policy_t policy = config->drop ? PIPELINE_DROP : PIPELINE_BLOCK;
+    const pipeline_stage_config_t stages[] = {
+        { .name = "produce", .fn = produce_stage, .core = 0, .priority = PIPELINE_SOURCE_PRIORITY,
+          .period_us = config->period_us },
+        { .name = "parse", .fn = parse_stage, .core = 0, .priority = PIPELINE_STAGE_PRIORITY,
+          .capacity = config->capacity, .policy = policy },
+        { .name = "transform", .fn = transform_stage, .core = 1, .priority = PIPELINE_STAGE_PRIORITY,
+          .capacity = config->capacity, .policy = policy },
+        { .name = "sink", .fn = sink_stage, .ctx = (void *)&sink, .core = 1,
+          .priority = PIPELINE_STAGE_PRIORITY, .capacity = config->capacity, .policy = policy },
+    };
+    _Static_assert(sizeof(pipeline_payload_t) <= PIPELINE_PAYLOAD, "payload must fit an item");
+
+    pipeline_t *pipeline = pipeline_create(stages, sizeof(stages) / sizeof(stages[0]), PIPELINE_PAYLOAD);
+    if(pipeline == NULL) {
+        printf("Failed to create the pipeline\n");
+        return false;
+    }
+
+    printf("Pipeline: produce -> parse (core 0) -> transform -> sink (core 1), "
+           "an item every %lu μs, channels of %lu, %s when full, %lu ms\n",
+           (unsigned long)config->period_us, (unsigned long)config->capacity,
+           config->drop ? "drop" : "block", (unsigned long)config->duration_ms);
+
+    UBaseType_t saved_priority = uxTaskPriorityGet(NULL);
+    vTaskPrioritySet(NULL, PIPELINE_RUNNER_PRIORITY);
+    static cpu_load_t load;  // too large for the caller's stack
+    cpu_load_start(&load);
+    uint64_t start = esp_timer_get_time();
+    bool ok = pipeline_start(pipeline);
+    if(ok) {
+        vTaskDelay(pdMS_TO_TICKS(config->duration_ms));
+        pipeline_stop(pipeline);
+    }
+    uint64_t elapsed = esp_timer_get_time() - start;
+    vTaskPrioritySet(NULL, saved_priority);
+
+    if(ok) {
+        char params[64];
+        snprintf(params, sizeof(params), "period_us=%lu capacity=%lu drop=%d", (unsigned long)config->period_us,
+                 (unsigned long)config->capacity, config->drop);
+        printf("\n=== Pipeline Results ===\n");
+        pipeline_report(pipeline, elapsed, params);
+        float busy[2];
+        cpu_load_update(&load, busy, true);
+    } else {
+        printf("Failed to start the pipeline stages\n");
+    }
+    pipeline_delete(pipeline);
+    return ok;
+}
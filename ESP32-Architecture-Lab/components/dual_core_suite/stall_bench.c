@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+#include "bench.h"
+#include "mailbox.h"
+#include "overwrite_ring.h"
+#include "dual_core_private.h"
+
+// Producer stall time behind a slow consumer. Each timed run is one
+// iteration of core0_task's protocol loop: the checksum work, then one
+// core_message_t sent to a helper on core 1 that holds every message it
+// takes for `consumer_us` before taking the next. Once the consumer falls
+// behind, the blocking queue makes the producer wait for a free slot on every
+// send, while the lossy transports replace an unread message instead.
+// Reported at teardown:
+//
+//   producer_stall  time spent in the send call, ns
+//   message_age     send to the consumer taking the message, μs: how stale
+//                   the data the consumer works on is
+//   messages_lost   messages replaced before the consumer took them
+//
+// "transport" parameter: 0 FreeRTOS queue (blocking send, as in the paced
+//                        workload), 3 latest-value mailbox, 4 drop-oldest ring
+// "consumer_us" parameter: consumer hold time per message; the producer's own
+//                        iteration is roughly 10 μs, so 10 keeps up and 100 and
+//                        1000 do not
+//
+// The warm-up runs fill the queue, so the distributions describe the steady
+// state of an overloaded consumer rather than the first CORE_QUEUE_LENGTH
+// free sends.
+
+#define STALL_MESSAGES 256
+#define STALL_WARMUP (2 * CORE_QUEUE_LENGTH)
+#define STALL_WORK_STEPS 1000
+#define STALL_SEND_TIMEOUT_MS 100    // as core0_task's paced send
+#define STALL_RECEIVE_TIMEOUT_MS 10  // how often a blocked consumer looks at the stop flag
+
+typedef struct {
+    dual_core_transport_t transport;
+    uint32_t consumer_us;
+    QueueHandle_t queue;
+    mailbox_t *mailbox;
+    overwrite_ring_t *ring;
+    core_message_t tx;              // producer's staging copy
+    core_message_t rx;              // consumer's copy
+    uint32_t sent;                  // runs so far, warm-up included
+    uint32_t timeouts;              // queue sends that gave up
+    atomic_uint received;           // written by the helper only
+    dual_core_helper_t helper;
+    bench_hist_t stall;             // ns, written by the measuring task only
+    bench_hist_t age;               // μs, written by the helper only
+} stall_run_t;
+
+static bool stall_send(stall_run_t *run) {
+    switch(run->transport) {
+        case DUAL_CORE_TRANSPORT_QUEUE:
+            return xQueueSend(run->queue, &run->tx, pdMS_TO_TICKS(STALL_SEND_TIMEOUT_MS)) == pdTRUE;
+        case DUAL_CORE_TRANSPORT_MAILBOX:
+            mailbox_post(run->mailbox, &run->tx);
+            return true;
+        default:
+            overwrite_ring_push(run->ring, &run->tx);
+            return true;
+    }
+}
+
+static bool stall_take(stall_run_t *run) {
+    switch(run->transport) {
+        case DUAL_CORE_TRANSPORT_QUEUE:
+            return xQueueReceive(run->queue, &run->rx, pdMS_TO_TICKS(STALL_RECEIVE_TIMEOUT_MS)) == pdTRUE;
+        case DUAL_CORE_TRANSPORT_MAILBOX:
+            return mailbox_take(run->mailbox, &run->rx);
+        default:
+            return overwrite_ring_pop(run->ring, &run->rx);
+    }
+}
+
+// Core 1: take a message, then sit on it for consumer_us
+static void stall_consumer_task(void *parameter) {
+    stall_run_t *run = parameter;
+
+    while(!atomic_load_explicit(&run->helper.stop, memory_order_acquire)) {
+        if(!stall_take(run)) {
+            continue;
+        }
+        int64_t taken = esp_timer_get_time();
+        bench_hist_record(&run->age, (uint32_t)(taken - run->rx.timestamp));
+        atomic_store_explicit(&run->received, atomic_load_explicit(&run->received, memory_order_relaxed) + 1,
+                              memory_order_release);
+        while(esp_timer_get_time() - taken < run->consumer_us) {
+        }
+    }
+
+    dual_core_helper_exit(&run->helper);
+}
+
+static void stall_teardown(bench_case_t *c);
+
+static bool stall_setup(bench_case_t *c) {
+    int32_t transport = c->values[0];
+    if((transport != DUAL_CORE_TRANSPORT_QUEUE && transport != DUAL_CORE_TRANSPORT_MAILBOX &&
+        transport != DUAL_CORE_TRANSPORT_DROP_OLDEST) || c->values[1] < 0) {
+        return false;
+    }
+
+    stall_run_t *run = heap_caps_calloc(1, sizeof(stall_run_t), MALLOC_CAP_INTERNAL);
+    if(run == NULL) {
+        return false;
+    }
+    run->transport = (dual_core_transport_t)transport;
+    run->consumer_us = c->values[1];
+    bench_hist_reset(&run->stall);
+    bench_hist_reset(&run->age);
+    c->state = run;
+
+    bool ok;
+    uint32_t caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+    switch(run->transport) {
+        case DUAL_CORE_TRANSPORT_QUEUE:
+            ok = (run->queue = xQueueCreate(CORE_QUEUE_LENGTH, sizeof(core_message_t))) != NULL;
+            break;
+        case DUAL_CORE_TRANSPORT_MAILBOX:
+            ok = (run->mailbox = mailbox_create(sizeof(core_message_t), caps)) != NULL;
+            break;
+        default:
+            ok = (run->ring = overwrite_ring_create(sizeof(core_message_t), CORE_QUEUE_LENGTH, caps)) != NULL;
+            break;
+    }
+
+    if(ok) {
+        ok = dual_core_helper_start(&run->helper, stall_consumer_task, "StallRx", 3072, run,
+                                    DUAL_CORE_HELPER_CORE, NULL);
+    }
+    if(!ok) {
+        stall_teardown(c);
+        return false;
+    }
+
+    c->elements = 1;
+    c->bytes = sizeof(core_message_t);
+    c->config.warmup_runs = STALL_WARMUP;
+    c->config.min_runs = STALL_MESSAGES;
+    c->config.max_runs = STALL_MESSAGES;
+    c->config.target_ci = 1.0;  // a fixed sample count: the spread is the result
+    return true;
+}
+
+static void stall_run(bench_case_t *c) {
+    stall_run_t *run = c->state;
+
+    // Simulate protocol processing work over the last message's bytes
+    uint32_t checksum = 0;
+    for(int j = 0; j < STALL_WORK_STEPS; j++) {
+        checksum += j * 997 + run->tx.data[j % sizeof(run->tx.data)];
+    }
+
+    run->tx.sender_core = 0;
+    run->tx.message_id = run->sent++;
+    memcpy(run->tx.data, &checksum, sizeof(checksum));
+    run->tx.timestamp = esp_timer_get_time();
+
+    bench_timer_t timer;
+    bench_timer_start(&timer);
+    bool sent = stall_send(run);
+    uint64_t cycles = bench_timer_stop(&timer);
+    if(!sent) {
+        run->timeouts++;
+    }
+    if(run->sent > STALL_WARMUP) {
+        bench_hist_record(&run->stall, (uint32_t)bench_cycles_to_ns(cycles));
+    }
+}
+
+static void stall_teardown(bench_case_t *c) {
+    stall_run_t *run = c->state;
+
+    dual_core_helper_join(&run->helper, NULL, NULL);
+
+    uint32_t lost = 0;
+    if(run->mailbox) {
+        lost = run->mailbox->overwritten;
+    } else if(run->ring) {
+        lost = run->ring->dropped;
+    }
+    if(run->queue) {
+        vQueueDelete(run->queue);
+    }
+    mailbox_delete(run->mailbox);
+    overwrite_ring_delete(run->ring);
+
+    if(run->stall.count > 0) {
+        char params[48];
+        char label[80];
+        snprintf(params, sizeof(params), "transport=%s consumer_us=%ld", dual_core_transport_name(run->transport),
+                 (long)c->values[1]);
+        snprintf(label, sizeof(label), "    send stall (%s)", params);
+        bench_hist_print(label, &run->stall, "ns");
+        snprintf(label, sizeof(label), "    message age (%s)", params);
+        bench_hist_print(label, &run->age, "μs");
+        printf("    %lu sent, %lu taken, %lu replaced unread, %lu send timeouts\n", (unsigned long)run->sent,
+               (unsigned long)atomic_load(&run->received), (unsigned long)lost, (unsigned long)run->timeouts);
+        bench_hist_report("dualcore", "producer_stall", params, "ns", &run->stall);
+        bench_hist_report("dualcore", "message_age", params, "us", &run->age);
+        bench_report_metric("dualcore", "messages_lost", params, "count", lost, false);
+    }
+    heap_caps_free(run);
+}
+
+BENCH_DEFINE(dualcore_producer_stall, "dualcore", "producer_stall", stall_setup, stall_run, stall_teardown,
+             BENCH_PARAM("transport", DUAL_CORE_TRANSPORT_QUEUE, DUAL_CORE_TRANSPORT_MAILBOX,
+                         DUAL_CORE_TRANSPORT_DROP_OLDEST),
+             BENCH_PARAM("consumer_us", 10, 100, 1000))
@@ -0,0 +1,322 @@
+#include <stdio.h>
+#include <stdatomic.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <esp_heap_caps.h>
+#include "bench.h"
+#include "spsc_ring.h"
+#include "msg_pool.h"
+#include "dual_core_private.h"
+
+// Core-to-core transport benchmarks: core_message_t-style traffic without
+// the workload's pacing, over a FreeRTOS queue, the SPSC ring, and pooled
+// buffers whose index goes through an SPSC ring (zero-copy). The measuring
+// task (core 0) produces; a helper task on core 1 consumes. The "payload"
+// axis sets the message body size: the producer writes every byte and the
+// consumer reads every byte, so only the transport's own copies differ.
+//
+//   transport_throughput  TRANSPORT_BATCH messages per run; cycles/element is
+//                         the cost per message at full rate
+//   transport_latency     TRANSPORT_PINGS round trips per run: the helper
+//                         echoes each message back. Only core 0's cycle
+//                         counter is used, so one-way latency is half the
+//                         cycles/element figure.
+//
+// The lossy transports (mailbox, drop_oldest) are left out: a run would never
+// see its last message arrive. stall_bench.c covers them, and varmsg_bench.c
+// the variable-length ring.
+
+#define TRANSPORT_BATCH 1024
+#define TRANSPORT_PINGS 64
+#define TRANSPORT_MAX_PAYLOAD 1024
+#define STOP_MESSAGE_ID UINT32_MAX
+
+// Same 16-byte header as core_message_t, followed by `payload` bytes
+typedef struct {
+    uint32_t sender_core;
+    uint32_t message_id;
+    uint64_t timestamp;
+    uint32_t data[];
+} transport_message_t;
+
+typedef struct {
+    dual_core_transport_t transport;
+    bool echo;
+    uint32_t payload_words;
+    uint32_t message_size;
+    QueueHandle_t request_queue;
+    QueueHandle_t reply_queue;
+    spsc_ring_t *request_ring;      // messages, or pool indices for the pool transport
+    spsc_ring_t *reply_ring;
+    msg_pool_t *pool;
+    transport_message_t *tx;        // producer's staging buffer (copying transports)
+    transport_message_t *rx;        // helper's receive buffer
+    transport_message_t *reply;     // producer's receive buffer
+    atomic_uint received;           // written by the helper only
+    dual_core_helper_t helper;
+    uint32_t checksum;              // keeps the consumer's reads observable
+} transport_run_t;
+
+static void fill_message(transport_run_t *run, transport_message_t *message, uint32_t id) {
+    message->sender_core = 0;
+    message->message_id = id;
+    for(uint32_t i = 0; i < run->payload_words; i++) {
+        message->data[i] = id + i;
+    }
+}
+
+static uint32_t read_message(transport_run_t *run, const transport_message_t *message) {
+    uint32_t sum = message->message_id;
+    for(uint32_t i = 0; i < run->payload_words; i++) {
+        sum += message->data[i];
+    }
+    return sum;
+}
+
+// Producer: build message `id` and hand it to core 1
+static void transport_send(transport_run_t *run, uint32_t id) {
+    switch(run->transport) {
+        case DUAL_CORE_TRANSPORT_QUEUE:
+            fill_message(run, run->tx, id);
+            xQueueSend(run->request_queue, run->tx, portMAX_DELAY);
+            break;
+        case DUAL_CORE_TRANSPORT_SPSC:
+            fill_message(run, run->tx, id);
+            while(!spsc_ring_push(run->request_ring, run->tx)) {
+            }
+            break;
+        default: {
+            transport_message_t *message;
+            while((message = msg_pool_alloc(run->pool)) == NULL) {
+            }
+            fill_message(run, message, id);
+            uint32_t index = msg_pool_index(run->pool, message);
+            while(!spsc_ring_push(run->request_ring, &index)) {
+            }
+            break;
+        }
+    }
+}
+
+// Producer: wait for the echo of the last message and read it
+static void transport_await_reply(transport_run_t *run) {
+    switch(run->transport) {
+        case DUAL_CORE_TRANSPORT_QUEUE:
+            xQueueReceive(run->reply_queue, run->reply, portMAX_DELAY);
+            run->checksum += read_message(run, run->reply);
+            break;
+        case DUAL_CORE_TRANSPORT_SPSC:
+            while(!spsc_ring_pop(run->reply_ring, run->reply)) {
+            }
+            run->checksum += read_message(run, run->reply);
+            break;
+        default: {
+            uint32_t index;
+            while(!spsc_ring_pop(run->reply_ring, &index)) {
+            }
+            transport_message_t *message = msg_pool_buffer(run->pool, index);
+            run->checksum += read_message(run, message);
+            msg_pool_free(run->pool, message);
+            break;
+        }
+    }
+}
+
+// Helper: take one message, read it and echo or release it. Returns false
+// when the ring is empty or the queue delivered the stop message.
+static bool transport_consume(transport_run_t *run, uint32_t *sum) {
+    switch(run->transport) {
+        case DUAL_CORE_TRANSPORT_QUEUE:
+            xQueueReceive(run->request_queue, run->rx, portMAX_DELAY);
+            if(run->rx->message_id == STOP_MESSAGE_ID) {
+                return false;
+            }
+            *sum += read_message(run, run->rx);
+            if(run->echo) {
+                xQueueSend(run->reply_queue, run->rx, portMAX_DELAY);
+            }
+            return true;
+        case DUAL_CORE_TRANSPORT_SPSC:
+            if(!spsc_ring_pop(run->request_ring, run->rx)) {
+                return false;
+            }
+            *sum += read_message(run, run->rx);
+            if(run->echo) {
+                while(!spsc_ring_push(run->reply_ring, run->rx)) {
+                }
+            }
+            return true;
+        default: {
+            uint32_t index;
+            if(!spsc_ring_pop(run->request_ring, &index)) {
+                return false;
+            }
+            transport_message_t *message = msg_pool_buffer(run->pool, index);
+            *sum += read_message(run, message);
+            if(run->echo) {
+                while(!spsc_ring_push(run->reply_ring, &index)) {  // same buffer goes back
+                }
+            } else {
+                msg_pool_free(run->pool, message);
+            }
+            return true;
+        }
+    }
+}
+
+// Core 1: consume requests until teardown asks it to stop
+static void transport_helper_task(void *parameter) {
+    transport_run_t *run = parameter;
+    uint32_t sum = 0;
+
+    while(!atomic_load_explicit(&run->helper.stop, memory_order_acquire)) {
+        if(!transport_consume(run, &sum)) {
+            if(run->transport == DUAL_CORE_TRANSPORT_QUEUE) {
+                break;  // stop message
+            }
+            continue;
+        }
+        atomic_store_explicit(&run->received, atomic_load_explicit(&run->received, memory_order_relaxed) + 1,
+                              memory_order_release);
+    }
+
+    run->checksum += sum;
+    dual_core_helper_exit(&run->helper);
+}
+
+// A queue helper blocks in xQueueReceive; the stop message ends it
+static void transport_wake(void *arg) {
+    transport_run_t *run = arg;
+
+    if(run->transport == DUAL_CORE_TRANSPORT_QUEUE) {
+        run->tx->message_id = STOP_MESSAGE_ID;
+        xQueueSend(run->request_queue, run->tx, portMAX_DELAY);
+    }
+}
+
+static void transport_teardown(bench_case_t *c);
+
+static bool transport_setup(bench_case_t *c, bool echo) {
+    int32_t payload = c->values[1];
+    if(c->values[0] < 0 || c->values[0] > DUAL_CORE_TRANSPORT_POOL ||
+       payload < 0 || payload > TRANSPORT_MAX_PAYLOAD || payload % sizeof(uint32_t) != 0) {
+        return false;
+    }
+
+    transport_run_t *run = heap_caps_calloc(1, sizeof(transport_run_t), MALLOC_CAP_INTERNAL);
+    if(run == NULL) {
+        return false;
+    }
+    run->transport = (dual_core_transport_t)c->values[0];
+    run->echo = echo;
+    run->payload_words = payload / sizeof(uint32_t);
+    run->message_size = sizeof(transport_message_t) + payload;
+    c->state = run;
+
+    bool ok;
+    uint32_t caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+    run->tx = heap_caps_malloc(run->message_size, caps);
+    run->rx = heap_caps_malloc(run->message_size, caps);
+    run->reply = heap_caps_malloc(run->message_size, caps);
+    switch(run->transport) {
+        case DUAL_CORE_TRANSPORT_QUEUE:
+            run->request_queue = xQueueCreate(CORE_QUEUE_LENGTH, run->message_size);
+            run->reply_queue = xQueueCreate(CORE_QUEUE_LENGTH, run->message_size);
+            ok = run->request_queue && run->reply_queue;
+            break;
+        case DUAL_CORE_TRANSPORT_SPSC:
+            run->request_ring = spsc_ring_create(run->message_size, CORE_QUEUE_LENGTH, caps);
+            run->reply_ring = spsc_ring_create(run->message_size, CORE_QUEUE_LENGTH, caps);
+            ok = run->request_ring && run->reply_ring;
+            break;
+        default:
+            // Both rings full plus one buffer at each end
+            run->pool = msg_pool_create(run->message_size, 2 * CORE_QUEUE_LENGTH + 2, caps);
+            run->request_ring = spsc_ring_create(sizeof(uint32_t), CORE_QUEUE_LENGTH, caps);
+            run->reply_ring = spsc_ring_create(sizeof(uint32_t), CORE_QUEUE_LENGTH, caps);
+            ok = run->pool && run->request_ring && run->reply_ring;
+            break;
+    }
+    ok = ok && run->tx && run->rx && run->reply;
+
+    if(ok) {
+        ok = dual_core_helper_start(&run->helper, transport_helper_task, "TransportRx", 3072, run,
+                                    DUAL_CORE_HELPER_CORE, NULL);
+    }
+    if(!ok) {
+        transport_teardown(c);
+        return false;
+    }
+    return true;
+}
+
+static bool throughput_setup(bench_case_t *c) {
+    if(!transport_setup(c, false)) {
+        return false;
+    }
+    transport_run_t *run = c->state;
+    c->elements = TRANSPORT_BATCH;
+    c->bytes = (uint64_t)TRANSPORT_BATCH * run->message_size;
+    return true;
+}
+
+static bool latency_setup(bench_case_t *c) {
+    if(!transport_setup(c, true)) {
+        return false;
+    }
+    c->elements = TRANSPORT_PINGS;
+    return true;
+}
+
+// The run ends when core 1 has taken the last message, not when core 0 has
+// queued it, so a transport cannot look fast by buffering
+static void throughput_run(bench_case_t *c) {
+    transport_run_t *run = c->state;
+    uint32_t target = atomic_load_explicit(&run->received, memory_order_relaxed) + TRANSPORT_BATCH;
+
+    for(uint32_t i = 0; i < TRANSPORT_BATCH; i++) {
+        transport_send(run, i);
+    }
+    while(atomic_load_explicit(&run->received, memory_order_acquire) != target) {
+    }
+}
+
+static void latency_run(bench_case_t *c) {
+    transport_run_t *run = c->state;
+
+    for(uint32_t i = 0; i < TRANSPORT_PINGS; i++) {
+        transport_send(run, i);
+        transport_await_reply(run);
+    }
+}
+
+static void transport_teardown(bench_case_t *c) {
+    transport_run_t *run = c->state;
+
+    dual_core_helper_join(&run->helper, transport_wake, run);
+
+    if(run->request_queue) {
+        vQueueDelete(run->request_queue);
+    }
+    if(run->reply_queue) {
+        vQueueDelete(run->reply_queue);
+    }
+    spsc_ring_delete(run->request_ring);
+    spsc_ring_delete(run->reply_ring);
+    msg_pool_delete(run->pool);
+    heap_caps_free(run->tx);
+    heap_caps_free(run->rx);
+    heap_caps_free(run->reply);
+    heap_caps_free(run);
+}
+
+#define TRANSPORT_AXES                                                                          \
+    BENCH_PARAM("transport", DUAL_CORE_TRANSPORT_QUEUE, DUAL_CORE_TRANSPORT_SPSC,               \
+                DUAL_CORE_TRANSPORT_POOL),                                                      \
+    BENCH_PARAM("payload", 32, 256, 512)
+
+BENCH_DEFINE(dualcore_transport_throughput, "dualcore", "transport_throughput",
+             throughput_setup, throughput_run, transport_teardown, TRANSPORT_AXES)
+BENCH_DEFINE(dualcore_transport_latency, "dualcore", "transport_latency",
+             latency_setup, latency_run, transport_teardown, TRANSPORT_AXES)
@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stdatomic.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/message_buffer.h>
+#include <esp_heap_caps.h>
+#include "bench.h"
+#include "spsc_ring.h"
+#include "varlen_ring.h"
+#include "dual_core_private.h"
+
+// Variable-length messaging: fixed worst-case slots vs length-prefixed
+// records. The measuring task (core 0) sends VARMSG_BATCH messages per run to
+// a helper on core 1, which reads every byte; the run ends when the helper
+// has the last one. The bench's bandwidth line is payload bytes per second,
+// and cycles/element the cost per message.
+//
+// "transport" parameter: 0 fixed slots: an SPSC ring of CORE_QUEUE_LENGTH
+//                          structs with room for VARMSG_MAX_PAYLOAD bytes,
+//                          copied whole whatever the message size (the
+//                          core_message_t approach, sized for the largest
+//                          message)
+//                        1 FreeRTOS message buffer of VARMSG_BUFFER_BYTES
+//                        2 varlen_ring_t of VARMSG_BUFFER_BYTES, written and
+//                          read in place
+// "sizes" parameter:     0 mixed: mostly tiny messages, some large (see
+//                          varmsg_draw_size()); 1 every message 32 bytes, the
+//                          workload's fixed payload
+//
+// The buffer footprint of each transport, and how many messages of the mix
+// fit in it, are printed at teardown.
+
+#define VARMSG_BATCH 512
+#define VARMSG_MIN_PAYLOAD 8
+#define VARMSG_MAX_PAYLOAD 1024
+#define VARMSG_BUFFER_BYTES 4096
+#define VARMSG_RECEIVE_TIMEOUT_MS 10  // how often a blocked helper looks at the stop flag
+
+enum { VARMSG_FIXED, VARMSG_MESSAGE_BUFFER, VARMSG_RING, VARMSG_TRANSPORTS };
+
+typedef struct {
+    uint32_t length;                                      // payload bytes in use
+    uint32_t data[VARMSG_MAX_PAYLOAD / sizeof(uint32_t)];
+} varmsg_slot_t;
+
+typedef struct {
+    int transport;
+    uint16_t sizes[VARMSG_BATCH];   // payload bytes of each message of a run
+    uint32_t footprint;             // buffer bytes of the transport
+    spsc_ring_t *slots;
+    MessageBufferHandle_t buffer;
+    varlen_ring_t *ring;
+    varmsg_slot_t *tx;              // producer's staging copy (fixed slots, message buffer)
+    varmsg_slot_t *rx;              // helper's receive copy
+    atomic_uint received;           // written by the helper only
+    dual_core_helper_t helper;
+    uint32_t checksum;              // keeps the helper's reads observable
+} varmsg_run_t;
+
+// Mixed sizes, multiples of 4 bytes: 70% 8-32 B (sensor readings, acks),
+// 20% up to 128 B, 8% up to 512 B and 2% up to 1 KB (log lines, blobs). The
+// mean is about 67 bytes. A fixed seed keeps the batch the same from run to run.
+static uint32_t varmsg_draw_size(uint32_t *seed) {
+    *seed = *seed * 1664525u + 1013904223u;
+    uint32_t r = *seed >> 8;
+    uint32_t bucket = r % 100;
+    r /= 100;
+    uint32_t low = VARMSG_MIN_PAYLOAD;
+    uint32_t high = 32;
+    if(bucket >= 98) {
+        low = 516;
+        high = VARMSG_MAX_PAYLOAD;
+    } else if(bucket >= 90) {
+        low = 132;
+        high = 512;
+    } else if(bucket >= 70) {
+        low = 36;
+        high = 128;
+    }
+    return low + (r % ((high - low) / 4 + 1)) * 4;
+}
+
+static void fill_payload(uint32_t *data, uint32_t length, uint32_t id) {
+    for(uint32_t i = 0; i < length / sizeof(uint32_t); i++) {
+        data[i] = id + i;
+    }
+}
+
+static uint32_t read_payload(const uint32_t *data, uint32_t length) {
+    uint32_t sum = 0;
+    for(uint32_t i = 0; i < length / sizeof(uint32_t); i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+// Producer: build message `id` and hand it to core 1, waiting for room
+static void varmsg_send(varmsg_run_t *run, uint32_t id) {
+    uint32_t length = run->sizes[id % VARMSG_BATCH];
+
+    switch(run->transport) {
+        case VARMSG_FIXED:
+            run->tx->length = length;
+            fill_payload(run->tx->data, length, id);
+            while(!spsc_ring_push(run->slots, run->tx)) {
+            }
+            break;
+        case VARMSG_MESSAGE_BUFFER:
+            fill_payload(run->tx->data, length, id);
+            xMessageBufferSend(run->buffer, run->tx->data, length, portMAX_DELAY);
+            break;
+        default: {
+            uint32_t *payload;
+            while((payload = varlen_ring_reserve(run->ring, length)) == NULL) {
+            }
+            fill_payload(payload, length, id);
+            varlen_ring_commit(run->ring, length);
+            break;
+        }
+    }
+}
+
+// Helper: take one message and read it; false if none arrived
+static bool varmsg_consume(varmsg_run_t *run, uint32_t *sum) {
+    switch(run->transport) {
+        case VARMSG_FIXED:
+            if(!spsc_ring_pop(run->slots, run->rx)) {
+                return false;
+            }
+            *sum += read_payload(run->rx->data, run->rx->length);
+            return true;
+        case VARMSG_MESSAGE_BUFFER: {
+            size_t length = xMessageBufferReceive(run->buffer, run->rx->data, sizeof(run->rx->data),
+                                                  pdMS_TO_TICKS(VARMSG_RECEIVE_TIMEOUT_MS));
+            if(length == 0) {
+                return false;
+            }
+            *sum += read_payload(run->rx->data, length);
+            return true;
+        }
+        default: {
+            uint32_t length;
+            const uint32_t *payload = varlen_ring_peek(run->ring, &length);
+            if(payload == NULL) {
+                return false;
+            }
+            *sum += read_payload(payload, length);
+            varlen_ring_release(run->ring);
+            return true;
+        }
+    }
+}
+
+// Core 1: consume until teardown asks it to stop
+static void varmsg_helper_task(void *parameter) {
+    varmsg_run_t *run = parameter;
+    uint32_t sum = 0;
+
+    while(!atomic_load_explicit(&run->helper.stop, memory_order_acquire)) {
+        if(!varmsg_consume(run, &sum)) {
+            continue;
+        }
+        atomic_store_explicit(&run->received, atomic_load_explicit(&run->received, memory_order_relaxed) + 1,
+                              memory_order_release);
+    }
+
+    run->checksum += sum;
+    dual_core_helper_exit(&run->helper);
+}
+
+static void varmsg_teardown(bench_case_t *c);
+
+static bool varmsg_setup(bench_case_t *c) {
+    if(c->values[0] < 0 || c->values[0] >= VARMSG_TRANSPORTS || c->values[1] < 0 || c->values[1] > 1) {
+        return false;
+    }
+
+    varmsg_run_t *run = heap_caps_calloc(1, sizeof(varmsg_run_t), MALLOC_CAP_INTERNAL);
+    if(run == NULL) {
+        return false;
+    }
+    run->transport = c->values[0];
+    c->state = run;
+
+    uint64_t bytes = 0;
+    uint32_t seed = 1;
+    for(uint32_t i = 0; i < VARMSG_BATCH; i++) {
+        run->sizes[i] = c->values[1] ? 32 : varmsg_draw_size(&seed);
+        bytes += run->sizes[i];
+    }
+
+    bool ok;
+    uint32_t caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+    run->tx = heap_caps_malloc(sizeof(varmsg_slot_t), caps);
+    run->rx = heap_caps_malloc(sizeof(varmsg_slot_t), caps);
+    switch(run->transport) {
+        case VARMSG_FIXED:
+            run->slots = spsc_ring_create(sizeof(varmsg_slot_t), CORE_QUEUE_LENGTH, caps);
+            run->footprint = CORE_QUEUE_LENGTH * sizeof(varmsg_slot_t);
+            ok = run->slots != NULL;
+            break;
+        case VARMSG_MESSAGE_BUFFER:
+            run->buffer = xMessageBufferCreate(VARMSG_BUFFER_BYTES);
+            run->footprint = VARMSG_BUFFER_BYTES;
+            ok = run->buffer != NULL;
+            break;
+        default:
+            run->ring = varlen_ring_create(VARMSG_BUFFER_BYTES, caps);
+            run->footprint = VARMSG_BUFFER_BYTES;
+            ok = run->ring != NULL;
+            break;
+    }
+    ok = ok && run->tx && run->rx;
+
+    if(ok) {
+        ok = dual_core_helper_start(&run->helper, varmsg_helper_task, "VarmsgRx", 3072, run,
+                                    DUAL_CORE_HELPER_CORE, NULL);
+    }
+    if(!ok) {
+        varmsg_teardown(c);
+        return false;
+    }
+
+    c->elements = VARMSG_BATCH;
+    c->bytes = bytes;
+    return true;
+}
+
+static void varmsg_run(bench_case_t *c) {
+    varmsg_run_t *run = c->state;
+    uint32_t target = atomic_load_explicit(&run->received, memory_order_relaxed) + VARMSG_BATCH;
+
+    for(uint32_t i = 0; i < VARMSG_BATCH; i++) {
+        varmsg_send(run, i);
+    }
+    while(atomic_load_explicit(&run->received, memory_order_acquire) != target) {
+    }
+}
+
+static void varmsg_teardown(bench_case_t *c) {
+    varmsg_run_t *run = c->state;
+
+    dual_core_helper_join(&run->helper, NULL, NULL);
+
+    if(atomic_load(&run->received) > 0) {
+        // Bytes one message of the batch's mean size takes in the buffer
+        uint64_t total = 0;
+        for(uint32_t i = 0; i < VARMSG_BATCH; i++) {
+            switch(run->transport) {
+                case VARMSG_FIXED: total += sizeof(varmsg_slot_t); break;
+                case VARMSG_MESSAGE_BUFFER: total += sizeof(size_t) + run->sizes[i]; break;
+                default: total += varlen_ring_record_size(run->sizes[i]); break;
+            }
+        }
+        double per_message = (double)total / VARMSG_BATCH;
+        double capacity = run->footprint / per_message;
+
+        char params[48];
+        snprintf(params, sizeof(params), "transport=%ld sizes=%ld", (long)c->values[0], (long)c->values[1]);
+        printf("    footprint: %lu buffer bytes, %.1f bytes per message, room for %.1f messages of this mix\n",
+               (unsigned long)run->footprint, per_message, capacity);
+        bench_report_metric("dualcore", "varmsg_footprint", params, "bytes", run->footprint, false);
+        bench_report_metric("dualcore", "varmsg_capacity", params, "messages", capacity, true);
+    }
+
+    if(run->buffer) {
+        vMessageBufferDelete(run->buffer);
+    }
+    spsc_ring_delete(run->slots);
+    varlen_ring_delete(run->ring);
+    heap_caps_free(run->tx);
+    heap_caps_free(run->rx);
+    heap_caps_free(run);
+}
+
+BENCH_DEFINE(dualcore_varmsg, "dualcore", "varmsg", varmsg_setup, varmsg_run, varmsg_teardown,
+             BENCH_PARAM("transport", VARMSG_FIXED, VARMSG_MESSAGE_BUFFER, VARMSG_RING),
+             BENCH_PARAM("sizes", 0, 1))
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "percore.h"
+
+// Two-worker job system: one worker task pinned to each core, each with its
+// own deque of jobs.
+//
+// A job is a function and an argument, submitted with a home core. Under
+// JOB_POOL_STEAL a worker runs its own deque newest-first, so a job that
+// submits follow-up work runs it while the data is still warm. When its
+// deque is empty it takes the oldest job from the other core's deque, so
+// bursty work spreads over both cores without rebalancing by hand.
+// JOB_POOL_STATIC (no stealing) and JOB_POOL_SHARED (one FIFO for both
+// workers) use the same machinery, so the policies can be compared directly.
+//
+// Each deque is guarded by its own spinlock. Jobs are submitted by tasks
+// other than the owning worker, which rules out the owner-only push of a
+// lock-free Chase-Lev deque, and the critical section covers a few loads
+// and stores only; the job itself runs outside it. An idle worker polls for
+// JOB_POOL_SPIN_POLLS rounds before parking on a task notification, and
+// submit only notifies workers that have parked.
+//
+// Jobs are counted in a job_group_t. job_group_wait() blocks the task that
+// initialised the group until every job submitted to it has run.
+
+#define JOB_POOL_CORES portNUM_PROCESSORS
+#define JOB_POOL_ANY_CORE (-1)      // home: the submitting task's core
+#define JOB_POOL_SPIN_POLLS 1024
+
+typedef void (*job_fn_t)(void *arg);
+
+typedef enum {
+    JOB_POOL_STATIC,  // a worker only runs jobs submitted to its core
+    JOB_POOL_SHARED,  // one FIFO queue for both workers; the home core is ignored
+    JOB_POOL_STEAL,   // own deque newest-first, then the other core's oldest job
+} job_pool_policy_t;
+
+// High bit: the owner is (about to be) blocked in job_group_wait(). Low
+// bits: jobs submitted to the group that have not finished. Both live in
+// one word so the last job can decide to wake the owner without touching
+// the group again afterwards, when it may already be gone.
+#define JOB_GROUP_WAITING 0x80000000u
+
+typedef struct {
+    atomic_uint state;
+    TaskHandle_t owner;
+} job_group_t;
+
+typedef struct {
+    job_fn_t fn;
+    void *arg;
+    job_group_t *group;
+} job_t;
+
+typedef struct {
+    _Alignas(PERCORE_CACHE_LINE) portMUX_TYPE lock;
+    atomic_uint top;       // oldest job, free-running
+    atomic_uint bottom;    // next free slot, free-running
+    job_t *slots;
+    uint32_t mask;         // capacity - 1
+
+    // Owning worker
+    TaskHandle_t task;
+    atomic_bool parked;
+    uint32_t executed;     // jobs this worker ran, stolen ones included
+    uint32_t stolen;       // jobs it took from the other core's deque
+} job_deque_t;
+
+typedef struct {
+    job_deque_t deques[JOB_POOL_CORES];
+    job_pool_policy_t policy;
+    atomic_bool stop;
+    atomic_uint running;   // live workers
+    void *allocation;
+} job_pool_t;
+
+// The calling task becomes the group's owner: only it may wait on the group
+void job_group_init(job_group_t *group);
+
+// Block until every job submitted to `group` has run
+void job_group_wait(job_group_t *group);
+
+// Workers at `priority`, each with a deque of `capacity` jobs (a power of
+// two). With JOB_POOL_SHARED every job goes to core 0's deque. NULL on
+// failure.
+job_pool_t *job_pool_create(job_pool_policy_t policy, UBaseType_t priority, uint32_t capacity);
+
+// Stop the workers and free the pool. Jobs still queued are dropped.
+void job_pool_delete(job_pool_t *pool);
+
+// Queue fn(arg) on `core`'s deque (JOB_POOL_ANY_CORE: the caller's core).
+// False if that deque is full; the job is then not counted in `group`.
+bool job_pool_submit(job_pool_t *pool, job_group_t *group, int core, job_fn_t fn, void *arg);
+
+// Clear the executed/stolen counters. Only while no jobs are queued.
+void job_pool_reset_counts(job_pool_t *pool);
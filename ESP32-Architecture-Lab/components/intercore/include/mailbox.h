@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "spsc_ring.h"
+
+// Lock-free latest-value mailbox (triple buffer) for one writer and one
+// reader, e.g. telemetry where only the newest sample matters.
+//
+// Three slots: the writer owns one and fills it, the reader owns one and
+// reads it, and the third holds the last published value. Posting swaps the
+// writer's slot with the published one; taking swaps the reader's slot with
+// it. Both swaps are a single atomic exchange (an S32C1I loop on Xtensa), so
+// neither side ever waits for the other or sees a torn value, and a post
+// never fails: a value the reader has not taken yet is simply replaced and
+// counted in `overwritten`.
+
+#define MAILBOX_SLOTS 3
+#define MAILBOX_FRESH 0x4u  // in `published`: the slot there has not been taken yet
+#define MAILBOX_INDEX 0x3u
+
+typedef struct {
+    // Writer side
+    _Alignas(SPSC_CACHE_LINE) uint32_t back;          // slot being filled
+    uint32_t overwritten;                             // values replaced before the reader took them
+
+    // Shared
+    _Alignas(SPSC_CACHE_LINE) atomic_uint published;  // slot of the last value | MAILBOX_FRESH
+
+    // Reader side
+    _Alignas(SPSC_CACHE_LINE) uint32_t front;         // slot of the value last taken
+
+    // Read-only after init
+    _Alignas(SPSC_CACHE_LINE) uint8_t *slots;
+    uint32_t slot_size;
+    void *allocation;                                 // set by mailbox_create()
+} mailbox_t;
+
+// Initialise `mailbox` over caller-provided storage of MAILBOX_SLOTS *
+// slot_size bytes. As with spsc_ring_init(), `mailbox` should be statically
+// allocated or come from mailbox_create() so the alignment holds.
+bool mailbox_init(mailbox_t *mailbox, void *storage, uint32_t slot_size);
+
+// Allocate a mailbox and its slots from heap_caps memory; NULL on failure
+mailbox_t *mailbox_create(uint32_t slot_size, uint32_t caps);
+void mailbox_delete(mailbox_t *mailbox);
+
+// Empty the mailbox and clear `overwritten`. Only valid while neither side
+// is using it.
+void mailbox_reset(mailbox_t *mailbox);
+
+// Writer: publish a copy of `value`. True if it replaced a value the reader
+// never took.
+static inline bool mailbox_post(mailbox_t *mailbox, const void *value) {
+    memcpy(mailbox->slots + mailbox->back * mailbox->slot_size, value, mailbox->slot_size);
+    uint32_t old = atomic_exchange_explicit(&mailbox->published, mailbox->back | MAILBOX_FRESH,
+                                            memory_order_acq_rel);
+    mailbox->back = old & MAILBOX_INDEX;
+    if(old & MAILBOX_FRESH) {
+        mailbox->overwritten++;
+        return true;
+    }
+    return false;
+}
+
+// Reader: copy out the newest value; false if nothing was posted since the
+// last take
+static inline bool mailbox_take(mailbox_t *mailbox, void *value) {
+    if(!(atomic_load_explicit(&mailbox->published, memory_order_relaxed) & MAILBOX_FRESH)) {
+        return false;
+    }
+    uint32_t old = atomic_exchange_explicit(&mailbox->published, mailbox->front, memory_order_acq_rel);
+    mailbox->front = old & MAILBOX_INDEX;
+    memcpy(value, mailbox->slots + mailbox->front * mailbox->slot_size, mailbox->slot_size);
+    return true;
+}
+
+// Whether a value is waiting; a snapshot from any task
+static inline bool mailbox_pending(mailbox_t *mailbox) {
+    return atomic_load_explicit(&mailbox->published, memory_order_acquire) & MAILBOX_FRESH;
+}
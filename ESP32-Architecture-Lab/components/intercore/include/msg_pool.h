@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "spsc_ring.h"
+
+// Lock-free pool of fixed-size message buffers for zero-copy handoff.
+//
+// A producer takes a buffer with msg_pool_alloc(), fills it in place and
+// passes only its index (or pointer) to the consumer, e.g. through an
+// spsc_ring_t of uint32_t; the consumer reads the message in place and gives
+// the buffer back with msg_pool_free(). The payload is never copied.
+//
+// Free buffers form a LIFO list whose head packs a 16-bit index with a
+// 16-bit version tag in one 32-bit word, updated with compare-and-swap
+// (S32C1I on Xtensa). The tag changes on every update, so a head that was
+// popped and pushed back between a load and its CAS is detected (ABA). Any
+// number of tasks on either core may allocate and free concurrently.
+
+#define MSG_POOL_MAX_BUFFERS 0xFFFF
+#define MSG_POOL_NONE 0xFFFFu  // end of the free list / no buffer
+
+typedef struct {
+    _Alignas(SPSC_CACHE_LINE) atomic_uint head;  // (tag << 16) | index of the first free buffer
+    atomic_uint available;                        // free buffers, for reporting only
+
+    _Alignas(SPSC_CACHE_LINE) uint8_t *buffers;  // read-only after create
+    _Atomic uint16_t *next;                       // free-list link per buffer
+    uint32_t buffer_size;                         // rounded up to SPSC_CACHE_LINE
+    uint32_t count;
+    void *allocation;
+} msg_pool_t;
+
+// `count` buffers of at least `buffer_size` bytes, each starting on its own
+// cache line, allocated from heap_caps memory with `caps`. NULL on failure.
+msg_pool_t *msg_pool_create(uint32_t buffer_size, uint32_t count, uint32_t caps);
+void msg_pool_delete(msg_pool_t *pool);
+
+// Take a free buffer; NULL if the pool is exhausted. Never blocks.
+void *msg_pool_alloc(msg_pool_t *pool);
+
+// Return a buffer obtained from msg_pool_alloc() on this pool
+void msg_pool_free(msg_pool_t *pool, void *buffer);
+
+static inline uint32_t msg_pool_index(const msg_pool_t *pool, const void *buffer) {
+    return (uint32_t)(((const uint8_t *)buffer - pool->buffers) / pool->buffer_size);
+}
+
+static inline void *msg_pool_buffer(const msg_pool_t *pool, uint32_t index) {
+    return pool->buffers + (size_t)index * pool->buffer_size;
+}
+
+static inline uint32_t msg_pool_available(msg_pool_t *pool) {
+    return atomic_load_explicit(&pool->available, memory_order_relaxed);
+}
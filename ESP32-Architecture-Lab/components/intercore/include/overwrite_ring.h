@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "spsc_ring.h"
+
+// Single-producer/single-consumer ring that drops its oldest item instead of
+// refusing a new one when full, so the producer never waits.
+//
+// Unlike spsc_ring_t, `tail` has two writers: the consumer advances it after
+// each read and the producer advances it to discard the oldest slot when the
+// ring is full. Both do so with compare-and-swap (S32C1I on Xtensa). The
+// consumer copies a slot first and only then claims it; if the producer
+// discarded that slot meanwhile (and may be overwriting it), the claim fails
+// and the consumer retries with the new oldest item, so a torn copy is never
+// returned. The producer claims before it writes, so it only ever writes a
+// slot nobody can still claim.
+
+typedef struct {
+    // Producer side
+    _Alignas(SPSC_CACHE_LINE) atomic_uint head;  // next slot to write, free-running
+    uint32_t dropped;                             // items discarded to make room
+
+    // Both sides
+    _Alignas(SPSC_CACHE_LINE) atomic_uint tail;  // oldest unread slot, free-running
+
+    // Read-only after init
+    _Alignas(SPSC_CACHE_LINE) uint8_t *slots;
+    uint32_t slot_size;
+    uint32_t mask;                                // capacity - 1
+    void *allocation;                             // set by overwrite_ring_create()
+} overwrite_ring_t;
+
+// Same contract as spsc_ring_init(): power-of-two capacity, storage of
+// capacity * slot_size bytes
+bool overwrite_ring_init(overwrite_ring_t *ring, void *storage, uint32_t slot_size, uint32_t capacity);
+overwrite_ring_t *overwrite_ring_create(uint32_t slot_size, uint32_t capacity, uint32_t caps);
+void overwrite_ring_delete(overwrite_ring_t *ring);
+
+// Empty the ring and clear `dropped`. Only valid while neither side is using it.
+void overwrite_ring_reset(overwrite_ring_t *ring);
+
+// Producer: copy one slot in, discarding the oldest item if the ring is
+// full. True if an item was discarded.
+static inline bool overwrite_ring_push(overwrite_ring_t *ring, const void *item) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    bool dropped = false;
+    // A failed claim means the consumer took the oldest item itself, which
+    // leaves room just the same
+    if(head - tail > ring->mask &&
+       atomic_compare_exchange_strong_explicit(&ring->tail, &tail, tail + 1, memory_order_acq_rel,
+                                               memory_order_acquire)) {
+        ring->dropped++;
+        dropped = true;
+    }
+    memcpy(ring->slots + (head & ring->mask) * ring->slot_size, item, ring->slot_size);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);  // publish the slot
+    return dropped;
+}
+
+// Consumer: copy the oldest item out; false if the ring is empty
+static inline bool overwrite_ring_pop(overwrite_ring_t *ring, void *item) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    for(;;) {
+        if(tail == atomic_load_explicit(&ring->head, memory_order_acquire)) {
+            return false;
+        }
+        memcpy(item, ring->slots + (tail & ring->mask) * ring->slot_size, ring->slot_size);
+        // Release: the copy is complete before the slot is handed back. On
+        // failure `tail` is reloaded with where the producer moved it.
+        if(atomic_compare_exchange_weak_explicit(&ring->tail, &tail, tail + 1, memory_order_acq_rel,
+                                                 memory_order_acquire)) {
+            return true;
+        }
+    }
+}
+
+// Items currently queued; a snapshot, as with spsc_ring_count()
+static inline uint32_t overwrite_ring_count(overwrite_ring_t *ring) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return atomic_load_explicit(&ring->head, memory_order_acquire) - tail;
+}
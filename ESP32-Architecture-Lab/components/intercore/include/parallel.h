@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "percore.h"
+
+// Split a loop over both cores.
+//
+// A parallel_pool_t owns one worker task pinned to each core. parallel_for()
+// cuts [0, count) into one contiguous chunk per core and calls fn() on each
+// chunk: the calling task runs its own core's chunk inline, and the worker
+// pinned to every other core runs that core's chunk. The worker on the
+// caller's core is not used, so the caller never competes with it.
+//
+// Start and join avoid the scheduler on the hot path. A worker that has just
+// finished a chunk spins on its job counter for PARALLEL_SPIN_POLLS polls
+// before blocking, so back-to-back calls start it with a single store; only a
+// parked worker gets a task notification. The caller joins by spinning on a
+// shared countdown, which it can do without starving anything because every
+// other chunk runs on another core.
+//
+// One caller at a time per pool. The caller may run on either core.
+
+#define PARALLEL_MAX_CORES portNUM_PROCESSORS
+#define PARALLEL_SPIN_POLLS 4096  // about 100 μs at 160 MHz before a worker blocks
+
+// One chunk: elements [begin, end) of the range, run on core `core`
+typedef void (*parallel_fn_t)(void *arg, uint32_t begin, uint32_t end, uint32_t core);
+
+typedef struct parallel_pool parallel_pool_t;
+
+typedef struct {
+    _Alignas(PERCORE_CACHE_LINE) atomic_uint posted;  // jobs posted to this worker, free-running
+    atomic_bool parked;                               // true while (about to be) blocked
+    TaskHandle_t task;
+    parallel_pool_t *pool;
+    uint32_t core;
+} parallel_worker_t;
+
+struct parallel_pool {
+    parallel_worker_t workers[PARALLEL_MAX_CORES];
+
+    // The current job, written by the caller before posting it
+    _Alignas(PERCORE_CACHE_LINE) parallel_fn_t fn;
+    void *arg;
+    uint32_t count;
+    uint32_t chunk;                                    // elements per core, a multiple of the grain
+
+    _Alignas(PERCORE_CACHE_LINE) atomic_uint pending;  // posted chunks not finished yet
+    atomic_uint running;                               // live workers
+    atomic_bool stop;
+};
+
+// Create a worker pinned to each core at `priority`; NULL on failure
+parallel_pool_t *parallel_pool_create(UBaseType_t priority);
+
+// Stop the workers and free the pool. Must not race parallel_for().
+void parallel_pool_delete(parallel_pool_t *pool);
+
+// Call fn() over [0, count) split across `cores` cores (1 .. PARALLEL_MAX_CORES;
+// 1 runs the whole range inline) and return once every chunk has finished.
+// Chunk boundaries fall on multiples of `grain` elements; for arrays written
+// by the kernel, one cache line's worth keeps the cores off each other's
+// lines. Cores whose chunk would be empty are not woken.
+void parallel_for(parallel_pool_t *pool, uint32_t count, uint32_t grain, uint32_t cores,
+                  parallel_fn_t fn, void *arg);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+// Per-core data that must not share a cache line (or an SRAM word) with
+// another core's data. Statics and array elements declared next to each
+// other are packed together, so counters written by both cores end up in
+// one line; wrapping each core's copy in PERCORE_PADDED() gives it a line
+// of its own:
+//
+//     static PERCORE_PADDED(my_stats_t) stats[portNUM_PROCESSORS];
+//     stats[xPortGetCoreID()].value.count++;
+//
+// The alignment only holds for statics and for heap blocks from
+// heap_caps_aligned_alloc()/heap_caps_aligned_calloc() with
+// PERCORE_CACHE_LINE alignment; plain malloc() guarantees 4 or 8 bytes.
+
+#define PERCORE_CACHE_LINE 32  // ESP32 flash/PSRAM cache line
+
+#define PERCORE_PADDED(type) struct { _Alignas(PERCORE_CACHE_LINE) type value; }
+
+// The common case: an event count and a running total, e.g. iterations and
+// the cycles they took. sizeof() is a whole cache line.
+typedef struct {
+    _Alignas(PERCORE_CACHE_LINE) uint32_t count;
+    uint64_t total;
+} percore_counter_t;
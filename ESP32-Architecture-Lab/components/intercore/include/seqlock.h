@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Sequence lock for publishing a small struct from one writer to any number
+// of readers, e.g. a task's running statistics read by a monitor on the
+// other core.
+//
+// The writer makes the sequence odd, updates the data and makes it even
+// again; it never waits. A reader copies the data between two reads of the
+// sequence and retries if the sequence was odd or changed, so it always ends
+// up with a copy from a single update: no torn 64-bit values and no counter
+// from one update paired with a total from another. Writers must be
+// serialised (normally there is exactly one).
+
+typedef struct {
+    atomic_uint sequence;
+} seqlock_t;
+
+#define SEQLOCK_INIT { 0 }
+
+static inline void seqlock_write(seqlock_t *lock, void *data, const void *value, size_t size) {
+    uint32_t sequence = atomic_load_explicit(&lock->sequence, memory_order_relaxed);
+    atomic_store_explicit(&lock->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);  // odd sequence before any data store
+    memcpy(data, value, size);
+    atomic_store_explicit(&lock->sequence, sequence + 2, memory_order_release);
+}
+
+static inline void seqlock_read(seqlock_t *lock, void *copy, const void *data, size_t size) {
+    uint32_t before;
+    uint32_t after;
+
+    do {
+        before = atomic_load_explicit(&lock->sequence, memory_order_acquire);
+        memcpy(copy, data, size);
+        atomic_thread_fence(memory_order_acquire);  // data loads before the second sequence load
+        after = atomic_load_explicit(&lock->sequence, memory_order_relaxed);
+    } while((before & 1) != 0 || before != after);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Lock-free single-producer/single-consumer ring of fixed-size slots.
+//
+// Exactly one task pushes and one task pops, normally pinned to different
+// cores. Neither side takes a spinlock or enters the scheduler: each index has
+// a single writer, so plain 32-bit loads and stores with acquire/release
+// ordering are enough (on Xtensa they compile to L32I/S32I plus MEMW; no
+// S32C1I compare-and-swap is needed). The producer's and the consumer's
+// indices sit on separate cache lines, and each side keeps a private copy of
+// the other's index so the shared line is only re-read when the ring looks
+// full or empty.
+//
+// A ring that can be empty or full never blocks; callers decide whether to
+// spin, yield or give up.
+
+#define SPSC_CACHE_LINE 32  // ESP32 flash/PSRAM cache line
+
+typedef struct {
+    // Producer side
+    _Alignas(SPSC_CACHE_LINE) atomic_uint head;  // next slot to write, free-running
+    uint32_t tail_cache;                          // producer's last view of `tail`
+
+    // Consumer side
+    _Alignas(SPSC_CACHE_LINE) atomic_uint tail;  // next slot to read, free-running
+    uint32_t head_cache;                          // consumer's last view of `head`
+
+    // Read-only after init
+    _Alignas(SPSC_CACHE_LINE) uint8_t *slots;
+    uint32_t slot_size;
+    uint32_t mask;                                // capacity - 1
+    void *allocation;                             // set by spsc_ring_create()
+} spsc_ring_t;
+
+// Initialise `ring` over caller-provided storage of capacity * slot_size
+// bytes. Capacity must be a power of two. `ring` itself should be statically
+// allocated or come from spsc_ring_create() so the alignment holds.
+bool spsc_ring_init(spsc_ring_t *ring, void *storage, uint32_t slot_size, uint32_t capacity);
+
+// Allocate a ring and its slots from heap_caps memory (e.g. MALLOC_CAP_INTERNAL
+// or MALLOC_CAP_SPIRAM); NULL if the allocation fails or capacity is invalid
+spsc_ring_t *spsc_ring_create(uint32_t slot_size, uint32_t capacity, uint32_t caps);
+void spsc_ring_delete(spsc_ring_t *ring);
+
+// Empty the ring. Only valid while neither side is using it.
+void spsc_ring_reset(spsc_ring_t *ring);
+
+static inline uint32_t spsc_ring_capacity(const spsc_ring_t *ring) {
+    return ring->mask + 1;
+}
+
+// Producer: copy one slot in; false if the ring is full
+static inline bool spsc_ring_push(spsc_ring_t *ring, const void *item) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if(head - ring->tail_cache > ring->mask) {
+        ring->tail_cache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if(head - ring->tail_cache > ring->mask) {
+            return false;
+        }
+    }
+    memcpy(ring->slots + (head & ring->mask) * ring->slot_size, item, ring->slot_size);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);  // publish the slot
+    return true;
+}
+
+// Consumer: copy one slot out; false if the ring is empty
+static inline bool spsc_ring_pop(spsc_ring_t *ring, void *item) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    if(tail == ring->head_cache) {
+        ring->head_cache = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if(tail == ring->head_cache) {
+            return false;
+        }
+    }
+    memcpy(item, ring->slots + (tail & ring->mask) * ring->slot_size, ring->slot_size);
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);  // hand the slot back
+    return true;
+}
+
+// Items currently queued. Exact only from the producer or the consumer; from
+// a third task it is a snapshot that may already be stale.
+static inline uint32_t spsc_ring_count(spsc_ring_t *ring) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return atomic_load_explicit(&ring->head, memory_order_acquire) - tail;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "spsc_ring.h"
+
+// Lock-free single-producer/single-consumer ring of variable-length
+// records, for messages whose size varies too much for fixed slots.
+//
+// The buffer is a power-of-two number of bytes. Each record is a 32-bit
+// length followed by the payload, padded to 4 bytes, so a message costs its
+// own size plus at most 7 bytes instead of a whole worst-case slot. A record
+// never straddles the end of the buffer: when it does not fit before the
+// end, the producer writes a wrap marker there and starts the record at
+// offset 0. Indices work as in spsc_ring_t (one writer each, byte offsets
+// instead of slot numbers, cached copies of the other side's index).
+//
+// Both sides can work in place: the producer reserves space, writes the
+// payload into it and commits the length it actually used; the consumer
+// peeks at the next record, reads it where it lies and releases it.
+// varlen_ring_push()/varlen_ring_pop() are the copying forms.
+
+#define VARLEN_RING_HEADER sizeof(uint32_t)
+#define VARLEN_RING_WRAP 0xFFFFFFFFu  // length word of the wrap marker
+
+typedef struct {
+    // Producer side
+    _Alignas(SPSC_CACHE_LINE) atomic_uint head;  // byte offset of the next record, free-running
+    uint32_t tail_cache;                          // producer's last view of `tail`
+    uint32_t reserved;                            // offset of the record being written
+    atomic_uint pushed;                           // records committed, for varlen_ring_count()
+
+    // Consumer side
+    _Alignas(SPSC_CACHE_LINE) atomic_uint tail;  // byte offset of the next record to read, free-running
+    uint32_t head_cache;                          // consumer's last view of `head`
+    uint32_t next;                                // offset just past the record being read
+    atomic_uint popped;                           // records released
+
+    // Read-only after init
+    _Alignas(SPSC_CACHE_LINE) uint8_t *buffer;
+    uint32_t mask;                                // size - 1
+    void *allocation;                             // set by varlen_ring_create()
+} varlen_ring_t;
+
+// Initialise `ring` over caller-provided storage of `size` bytes, a power of
+// two, at least 4-byte aligned. As with spsc_ring_init(), `ring` should be
+// statically allocated or come from varlen_ring_create() so the alignment holds.
+bool varlen_ring_init(varlen_ring_t *ring, void *storage, uint32_t size);
+
+// Allocate a ring and its buffer from heap_caps memory; NULL on failure
+varlen_ring_t *varlen_ring_create(uint32_t size, uint32_t caps);
+void varlen_ring_delete(varlen_ring_t *ring);
+
+// Empty the ring. Only valid while neither side is using it.
+void varlen_ring_reset(varlen_ring_t *ring);
+
+// Bytes a record of `length` payload bytes takes up
+static inline uint32_t varlen_ring_record_size(uint32_t length) {
+    return (VARLEN_RING_HEADER + length + 3) & ~3u;
+}
+
+// Largest payload: a record may take up to half the buffer, which
+// guarantees that one skipped by a wrap marker still fits once the consumer
+// has caught up
+static inline uint32_t varlen_ring_max_length(const varlen_ring_t *ring) {
+    return (ring->mask + 1) / 2 - VARLEN_RING_HEADER;
+}
+
+// Producer: space for a payload of up to `length` bytes, or NULL if the ring
+// is too full right now (or `length` exceeds varlen_ring_max_length()).
+// Nothing is visible to the consumer until varlen_ring_commit().
+static inline void *varlen_ring_reserve(varlen_ring_t *ring, uint32_t length) {
+    if(length > varlen_ring_max_length(ring)) {
+        return NULL;
+    }
+    uint32_t size = ring->mask + 1;
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t offset = head & ring->mask;
+    uint32_t record = varlen_ring_record_size(length);
+    uint32_t skip = size - offset < record ? size - offset : 0;  // to the end, for the wrap marker
+
+    if(head + skip + record - ring->tail_cache > size) {
+        ring->tail_cache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if(head + skip + record - ring->tail_cache > size) {
+            return NULL;
+        }
+    }
+    if(skip > 0) {
+        *(uint32_t *)(ring->buffer + offset) = VARLEN_RING_WRAP;
+    }
+    ring->reserved = head + skip;
+    return ring->buffer + (ring->reserved & ring->mask) + VARLEN_RING_HEADER;
+}
+
+// Producer: publish the reserved record with its final length, at most the
+// length reserved
+static inline void varlen_ring_commit(varlen_ring_t *ring, uint32_t length) {
+    *(uint32_t *)(ring->buffer + (ring->reserved & ring->mask)) = length;
+    atomic_store_explicit(&ring->pushed, atomic_load_explicit(&ring->pushed, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    // Publishes the wrap marker, if any, together with the record
+    atomic_store_explicit(&ring->head, ring->reserved + varlen_ring_record_size(length), memory_order_release);
+}
+
+// Consumer: the next record's payload and length, or NULL if the ring is
+// empty. The record stays in the ring until varlen_ring_release().
+static inline const void *varlen_ring_peek(varlen_ring_t *ring, uint32_t *length) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    if(tail == ring->head_cache) {
+        ring->head_cache = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if(tail == ring->head_cache) {
+            return NULL;
+        }
+    }
+    uint32_t word = *(const uint32_t *)(ring->buffer + (tail & ring->mask));
+    if(word == VARLEN_RING_WRAP) {
+        // The record after a marker was committed with it, so it is there
+        tail += ring->mask + 1 - (tail & ring->mask);
+        word = *(const uint32_t *)ring->buffer;
+    }
+    *length = word;
+    ring->next = tail + varlen_ring_record_size(word);
+    return ring->buffer + (tail & ring->mask) + VARLEN_RING_HEADER;
+}
+
+// Consumer: hand the peeked record's space back to the producer
+static inline void varlen_ring_release(varlen_ring_t *ring) {
+    atomic_store_explicit(&ring->popped, atomic_load_explicit(&ring->popped, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, ring->next, memory_order_release);
+}
+
+// Producer: copy a record in; false if it does not fit right now
+static inline bool varlen_ring_push(varlen_ring_t *ring, const void *data, uint32_t length) {
+    void *payload = varlen_ring_reserve(ring, length);
+    if(payload == NULL) {
+        return false;
+    }
+    memcpy(payload, data, length);
+    varlen_ring_commit(ring, length);
+    return true;
+}
+
+// Consumer: copy the next record out, truncated to `capacity` bytes; false if
+// the ring is empty. `length` receives the record's full length.
+static inline bool varlen_ring_pop(varlen_ring_t *ring, void *data, uint32_t capacity, uint32_t *length) {
+    const void *payload = varlen_ring_peek(ring, length);
+    if(payload == NULL) {
+        return false;
+    }
+    memcpy(data, payload, *length < capacity ? *length : capacity);
+    varlen_ring_release(ring);
+    return true;
+}
+
+// Records currently queued; a snapshot, as with spsc_ring_count()
+static inline uint32_t varlen_ring_count(varlen_ring_t *ring) {
+    uint32_t popped = atomic_load_explicit(&ring->popped, memory_order_relaxed);
+    return atomic_load_explicit(&ring->pushed, memory_order_relaxed) - popped;
+}
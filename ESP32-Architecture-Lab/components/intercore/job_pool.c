@@ -0,0 +1,240 @@
+#include <esp_heap_caps.h>
+#include "job_pool.h"
+
+void job_group_init(job_group_t *group) {
+    atomic_init(&group->state, 0);
+    group->owner = xTaskGetCurrentTaskHandle();
+}
+
+void job_group_wait(job_group_t *group) {
+    for(;;) {
+        uint32_t state = atomic_load(&group->state);
+        if((state & ~JOB_GROUP_WAITING) == 0) {
+            // The last job saw the flag and has notified us: that is what
+            // ended the block below, so only the flag is left to clear
+            atomic_store(&group->state, 0);
+            return;
+        }
+        if(atomic_compare_exchange_weak(&group->state, &state, state | JOB_GROUP_WAITING)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+    }
+}
+
+static void job_finish(job_group_t *group) {
+    // Read before the decrement: once the count reaches zero the owner may
+    // return and reuse the group
+    TaskHandle_t owner = group->owner;
+    if(atomic_fetch_sub(&group->state, 1) == (JOB_GROUP_WAITING | 1)) {
+        xTaskNotifyGive(owner);
+    }
+}
+
+static bool deque_empty(job_deque_t *deque) {
+    return atomic_load(&deque->top) == atomic_load(&deque->bottom);
+}
+
+static bool deque_push(job_deque_t *deque, const job_t *job) {
+    bool pushed = false;
+    portENTER_CRITICAL(&deque->lock);
+    uint32_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    if(bottom - atomic_load_explicit(&deque->top, memory_order_relaxed) <= deque->mask) {
+        deque->slots[bottom & deque->mask] = *job;
+        atomic_store(&deque->bottom, bottom + 1);  // a parking worker re-checks this
+        pushed = true;
+    }
+    portEXIT_CRITICAL(&deque->lock);
+    return pushed;
+}
+
+// Newest job: the owner's end of the deque
+static bool deque_pop_bottom(job_deque_t *deque, job_t *job) {
+    bool popped = false;
+    portENTER_CRITICAL(&deque->lock);
+    uint32_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    if(bottom != atomic_load_explicit(&deque->top, memory_order_relaxed)) {
+        *job = deque->slots[(bottom - 1) & deque->mask];
+        atomic_store_explicit(&deque->bottom, bottom - 1, memory_order_relaxed);
+        popped = true;
+    }
+    portEXIT_CRITICAL(&deque->lock);
+    return popped;
+}
+
+// Oldest job: the thieves' end, and the FIFO end of the shared queue
+static bool deque_pop_top(job_deque_t *deque, job_t *job) {
+    bool popped = false;
+    portENTER_CRITICAL(&deque->lock);
+    uint32_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    if(top != atomic_load_explicit(&deque->bottom, memory_order_relaxed)) {
+        *job = deque->slots[top & deque->mask];
+        atomic_store_explicit(&deque->top, top + 1, memory_order_relaxed);
+        popped = true;
+    }
+    portEXIT_CRITICAL(&deque->lock);
+    return popped;
+}
+
+static bool job_take(job_pool_t *pool, uint32_t core, job_t *job) {
+    job_deque_t *own = &pool->deques[core];
+
+    switch(pool->policy) {
+        case JOB_POOL_STATIC:
+            return deque_pop_bottom(own, job);
+        case JOB_POOL_SHARED:
+            return deque_pop_top(&pool->deques[0], job);
+        default:
+            if(deque_pop_bottom(own, job)) {
+                return true;
+            }
+            for(uint32_t other = 0; other < JOB_POOL_CORES; other++) {
+                if(other != core && deque_pop_top(&pool->deques[other], job)) {
+                    own->stolen++;
+                    return true;
+                }
+            }
+            return false;
+    }
+}
+
+// Whether job_take() could find anything, without taking the locks
+static bool job_available(job_pool_t *pool, uint32_t core) {
+    switch(pool->policy) {
+        case JOB_POOL_STATIC:
+            return !deque_empty(&pool->deques[core]);
+        case JOB_POOL_SHARED:
+            return !deque_empty(&pool->deques[0]);
+        default:
+            for(uint32_t other = 0; other < JOB_POOL_CORES; other++) {
+                if(!deque_empty(&pool->deques[other])) {
+                    return true;
+                }
+            }
+            return false;
+    }
+}
+
+static void job_worker_task(void *parameter) {
+    job_pool_t *pool = parameter;
+    uint32_t core = xPortGetCoreID();
+    job_deque_t *own = &pool->deques[core];
+
+    while(!atomic_load(&pool->stop)) {
+        job_t job;
+        if(job_take(pool, core, &job)) {
+            job.fn(job.arg);
+            own->executed++;
+            job_finish(job.group);
+            continue;
+        }
+
+        uint32_t polls = 0;
+        while(polls < JOB_POOL_SPIN_POLLS && !job_available(pool, core)) {
+            polls++;
+        }
+        if(polls < JOB_POOL_SPIN_POLLS) {
+            continue;
+        }
+        // Announce the park, then look again: a job pushed after this store
+        // sees `parked` and notifies, one pushed before it is seen here
+        atomic_store(&own->parked, true);
+        if(!job_available(pool, core) && !atomic_load(&pool->stop)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        atomic_store(&own->parked, false);
+    }
+
+    atomic_fetch_sub(&pool->running, 1);
+    vTaskDelete(NULL);
+}
+
+job_pool_t *job_pool_create(job_pool_policy_t policy, UBaseType_t priority, uint32_t capacity) {
+    if(policy > JOB_POOL_STEAL || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return NULL;
+    }
+
+    // One allocation: the pool header, then each core's slots
+    size_t header = (sizeof(job_pool_t) + PERCORE_CACHE_LINE - 1) & ~(size_t)(PERCORE_CACHE_LINE - 1);
+    size_t slots = capacity * sizeof(job_t);
+    uint8_t *block = heap_caps_aligned_calloc(PERCORE_CACHE_LINE, 1, header + JOB_POOL_CORES * slots,
+                                              MALLOC_CAP_INTERNAL);
+    if(block == NULL) {
+        return NULL;
+    }
+
+    job_pool_t *pool = (job_pool_t *)block;
+    pool->policy = policy;
+    pool->allocation = block;
+    for(uint32_t core = 0; core < JOB_POOL_CORES; core++) {
+        job_deque_t *deque = &pool->deques[core];
+        portMUX_INITIALIZE(&deque->lock);
+        deque->slots = (job_t *)(block + header + core * slots);
+        deque->mask = capacity - 1;
+    }
+
+    for(uint32_t core = 0; core < JOB_POOL_CORES; core++) {
+        atomic_fetch_add(&pool->running, 1);
+        if(xTaskCreatePinnedToCore(job_worker_task, "JobWorker", 3072, pool, priority,
+                                   &pool->deques[core].task, core) != pdPASS) {
+            atomic_fetch_sub(&pool->running, 1);
+            job_pool_delete(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+void job_pool_delete(job_pool_t *pool) {
+    if(pool == NULL) {
+        return;
+    }
+
+    atomic_store(&pool->stop, true);
+    for(uint32_t core = 0; core < JOB_POOL_CORES; core++) {
+        if(pool->deques[core].task) {
+            xTaskNotifyGive(pool->deques[core].task);
+        }
+    }
+    while(atomic_load(&pool->running) != 0) {
+        vTaskDelay(1);
+    }
+    heap_caps_free(pool->allocation);
+}
+
+bool job_pool_submit(job_pool_t *pool, job_group_t *group, int core, job_fn_t fn, void *arg) {
+    if(core == JOB_POOL_ANY_CORE) {
+        core = xPortGetCoreID();
+    }
+    if(core < 0 || core >= JOB_POOL_CORES) {
+        return false;
+    }
+    if(pool->policy == JOB_POOL_SHARED) {
+        core = 0;
+    }
+
+    // Count the job before it can run, or it could finish the group early
+    job_t job = { .fn = fn, .arg = arg, .group = group };
+    atomic_fetch_add(&group->state, 1);
+    if(!deque_push(&pool->deques[core], &job)) {
+        job_finish(group);  // wakes the owner if it was waiting for just this one
+        return false;
+    }
+
+    // The home worker, and under the other policies any parked worker that
+    // could take the job instead
+    for(uint32_t other = 0; other < JOB_POOL_CORES; other++) {
+        job_deque_t *deque = &pool->deques[other];
+        bool eligible = pool->policy != JOB_POOL_STATIC || other == (uint32_t)core;
+        if(eligible && atomic_load(&deque->parked)) {
+            xTaskNotifyGive(deque->task);
+        }
+    }
+    return true;
+}
+
+void job_pool_reset_counts(job_pool_t *pool) {
+    for(uint32_t core = 0; core < JOB_POOL_CORES; core++) {
+        pool->deques[core].executed = 0;
+        pool->deques[core].stolen = 0;
+    }
+}
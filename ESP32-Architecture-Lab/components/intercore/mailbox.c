@@ -0,0 +1,44 @@
+#include <esp_heap_caps.h>
+#include "mailbox.h"
+
+bool mailbox_init(mailbox_t *mailbox, void *storage, uint32_t slot_size) {
+    if(storage == NULL || slot_size == 0) {
+        return false;
+    }
+
+    mailbox->slots = storage;
+    mailbox->slot_size = slot_size;
+    mailbox->allocation = NULL;
+    mailbox_reset(mailbox);
+    return true;
+}
+
+mailbox_t *mailbox_create(uint32_t slot_size, uint32_t caps) {
+    // One allocation: the mailbox header, then the slots on the next cache line
+    size_t header = (sizeof(mailbox_t) + SPSC_CACHE_LINE - 1) & ~(size_t)(SPSC_CACHE_LINE - 1);
+    uint8_t *block = heap_caps_aligned_alloc(SPSC_CACHE_LINE, header + (size_t)slot_size * MAILBOX_SLOTS, caps);
+    if(block == NULL) {
+        return NULL;
+    }
+
+    mailbox_t *mailbox = (mailbox_t *)block;
+    if(!mailbox_init(mailbox, block + header, slot_size)) {
+        heap_caps_free(block);
+        return NULL;
+    }
+    mailbox->allocation = block;
+    return mailbox;
+}
+
+void mailbox_delete(mailbox_t *mailbox) {
+    if(mailbox && mailbox->allocation) {
+        heap_caps_free(mailbox->allocation);
+    }
+}
+
+void mailbox_reset(mailbox_t *mailbox) {
+    mailbox->back = 0;
+    atomic_store_explicit(&mailbox->published, 1, memory_order_relaxed);  // not fresh
+    mailbox->front = 2;
+    mailbox->overwritten = 0;
+}
@@ -0,0 +1,75 @@
+#include <esp_heap_caps.h>
+#include "msg_pool.h"
+
+#define HEAD_INDEX(head) ((head) & 0xFFFFu)
+#define HEAD_NEXT_TAG(head) (((head) + 0x10000u) & 0xFFFF0000u)
+
+msg_pool_t *msg_pool_create(uint32_t buffer_size, uint32_t count, uint32_t caps) {
+    if(buffer_size == 0 || count == 0 || count >= MSG_POOL_MAX_BUFFERS) {
+        return NULL;
+    }
+
+    // One allocation: pool header, buffers, then the free-list links
+    size_t line = SPSC_CACHE_LINE;
+    size_t header = (sizeof(msg_pool_t) + line - 1) & ~(line - 1);
+    size_t stride = (buffer_size + line - 1) & ~(line - 1);
+    size_t links = count * sizeof(uint16_t);
+    uint8_t *block = heap_caps_aligned_alloc(line, header + stride * count + links, caps);
+    if(block == NULL) {
+        return NULL;
+    }
+
+    msg_pool_t *pool = (msg_pool_t *)block;
+    pool->buffers = block + header;
+    pool->next = (_Atomic uint16_t *)(pool->buffers + stride * count);
+    pool->buffer_size = stride;
+    pool->count = count;
+    pool->allocation = block;
+
+    for(uint32_t i = 0; i < count; i++) {
+        atomic_init(&pool->next[i], i + 1 < count ? i + 1 : MSG_POOL_NONE);
+    }
+    atomic_init(&pool->head, 0);
+    atomic_init(&pool->available, count);
+    return pool;
+}
+
+void msg_pool_delete(msg_pool_t *pool) {
+    if(pool) {
+        heap_caps_free(pool->allocation);
+    }
+}
+
+void *msg_pool_alloc(msg_pool_t *pool) {
+    uint32_t head = atomic_load_explicit(&pool->head, memory_order_acquire);
+    uint32_t index;
+
+    do {
+        index = HEAD_INDEX(head);
+        if(index == MSG_POOL_NONE) {
+            return NULL;
+        }
+        // `next` may be stale if another task took this buffer meanwhile;
+        // the tag makes the CAS fail in that case
+        uint32_t next = atomic_load_explicit(&pool->next[index], memory_order_relaxed);
+        if(atomic_compare_exchange_weak_explicit(&pool->head, &head, HEAD_NEXT_TAG(head) | next,
+                                                 memory_order_acquire, memory_order_acquire)) {
+            break;
+        }
+    } while(true);
+
+    atomic_fetch_sub_explicit(&pool->available, 1, memory_order_relaxed);
+    return msg_pool_buffer(pool, index);
+}
+
+void msg_pool_free(msg_pool_t *pool, void *buffer) {
+    uint32_t index = msg_pool_index(pool, buffer);
+    uint32_t head = atomic_load_explicit(&pool->head, memory_order_relaxed);
+
+    do {
+        atomic_store_explicit(&pool->next[index], HEAD_INDEX(head), memory_order_relaxed);
+    } while(!atomic_compare_exchange_weak_explicit(&pool->head, &head, HEAD_NEXT_TAG(head) | index,
+                                                   memory_order_release, memory_order_relaxed));
+
+    atomic_fetch_add_explicit(&pool->available, 1, memory_order_relaxed);
+}
@@ -0,0 +1,44 @@
+#include <esp_heap_caps.h>
+#include "overwrite_ring.h"
+
+bool overwrite_ring_init(overwrite_ring_t *ring, void *storage, uint32_t slot_size, uint32_t capacity) {
+    if(storage == NULL || slot_size == 0 || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+
+    ring->slots = storage;
+    ring->slot_size = slot_size;
+    ring->mask = capacity - 1;
+    ring->allocation = NULL;
+    overwrite_ring_reset(ring);
+    return true;
+}
+
+overwrite_ring_t *overwrite_ring_create(uint32_t slot_size, uint32_t capacity, uint32_t caps) {
+    // One allocation: the ring header, then the slots on the next cache line
+    size_t header = (sizeof(overwrite_ring_t) + SPSC_CACHE_LINE - 1) & ~(size_t)(SPSC_CACHE_LINE - 1);
+    uint8_t *block = heap_caps_aligned_alloc(SPSC_CACHE_LINE, header + (size_t)slot_size * capacity, caps);
+    if(block == NULL) {
+        return NULL;
+    }
+
+    overwrite_ring_t *ring = (overwrite_ring_t *)block;
+    if(!overwrite_ring_init(ring, block + header, slot_size, capacity)) {
+        heap_caps_free(block);
+        return NULL;
+    }
+    ring->allocation = block;
+    return ring;
+}
+
+void overwrite_ring_delete(overwrite_ring_t *ring) {
+    if(ring && ring->allocation) {
+        heap_caps_free(ring->allocation);
+    }
+}
+
+void overwrite_ring_reset(overwrite_ring_t *ring) {
+    atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, 0, memory_order_relaxed);
+    ring->dropped = 0;
+}
@@ -0,0 +1,144 @@
+#include <esp_heap_caps.h>
+#include "parallel.h"
+
+static void chunk_bounds(const parallel_pool_t *pool, uint32_t index, uint32_t *begin, uint32_t *end) {
+    uint32_t first = index * pool->chunk;
+    *begin = first < pool->count ? first : pool->count;
+    *end = pool->count - *begin > pool->chunk ? *begin + pool->chunk : pool->count;
+}
+
+// Spin briefly for the next job, then park. Returns the new job count, which
+// is `seen` again only if the pool is stopping.
+static uint32_t wait_for_job(parallel_worker_t *worker, uint32_t seen) {
+    parallel_pool_t *pool = worker->pool;
+
+    for(;;) {
+        for(uint32_t i = 0; i < PARALLEL_SPIN_POLLS; i++) {
+            uint32_t posted = atomic_load_explicit(&worker->posted, memory_order_acquire);
+            if(posted != seen) {
+                return posted;
+            }
+        }
+        // Announce the park, then look again: a job posted after this store
+        // sees `parked` and sends a notification, one posted before it is
+        // seen here. A stale notification only costs one extra loop.
+        atomic_store(&worker->parked, true);
+        if(atomic_load(&worker->posted) == seen && !atomic_load(&pool->stop)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        atomic_store(&worker->parked, false);
+        if(atomic_load(&pool->stop)) {
+            return seen;
+        }
+    }
+}
+
+static void parallel_worker_task(void *parameter) {
+    parallel_worker_t *worker = parameter;
+    parallel_pool_t *pool = worker->pool;
+    uint32_t seen = 0;
+
+    for(;;) {
+        uint32_t posted = wait_for_job(worker, seen);
+        if(posted == seen) {
+            break;  // stopping
+        }
+        seen = posted;
+
+        uint32_t begin, end;
+        chunk_bounds(pool, worker->core, &begin, &end);
+        pool->fn(pool->arg, begin, end, worker->core);
+        atomic_fetch_sub_explicit(&pool->pending, 1, memory_order_release);
+    }
+
+    atomic_fetch_sub(&pool->running, 1);
+    vTaskDelete(NULL);
+}
+
+parallel_pool_t *parallel_pool_create(UBaseType_t priority) {
+    parallel_pool_t *pool = heap_caps_aligned_calloc(PERCORE_CACHE_LINE, 1, sizeof(parallel_pool_t),
+                                                     MALLOC_CAP_INTERNAL);
+    if(pool == NULL) {
+        return NULL;
+    }
+
+    for(uint32_t core = 0; core < PARALLEL_MAX_CORES; core++) {
+        parallel_worker_t *worker = &pool->workers[core];
+        worker->pool = pool;
+        worker->core = core;
+        atomic_fetch_add(&pool->running, 1);
+        if(xTaskCreatePinnedToCore(parallel_worker_task, "Parallel", 2048, worker, priority,
+                                   &worker->task, core) != pdPASS) {
+            atomic_fetch_sub(&pool->running, 1);
+            parallel_pool_delete(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+void parallel_pool_delete(parallel_pool_t *pool) {
+    if(pool == NULL) {
+        return;
+    }
+
+    atomic_store(&pool->stop, true);
+    for(uint32_t core = 0; core < PARALLEL_MAX_CORES; core++) {
+        if(pool->workers[core].task) {
+            xTaskNotifyGive(pool->workers[core].task);
+        }
+    }
+    while(atomic_load(&pool->running) != 0) {
+        vTaskDelay(1);
+    }
+    heap_caps_free(pool);
+}
+
+void parallel_for(parallel_pool_t *pool, uint32_t count, uint32_t grain, uint32_t cores,
+                  parallel_fn_t fn, void *arg) {
+    uint32_t self = xPortGetCoreID();
+
+    if(cores > PARALLEL_MAX_CORES) {
+        cores = PARALLEL_MAX_CORES;
+    }
+    if(grain == 0) {
+        grain = 1;
+    }
+    if(cores <= 1 || count <= grain) {
+        fn(arg, 0, count, self);
+        return;
+    }
+
+    // Per-core chunk rounded up to the grain; the last core takes the remainder
+    uint32_t chunk = (count + cores - 1) / cores;
+    chunk = (chunk + grain - 1) / grain * grain;
+    pool->fn = fn;
+    pool->arg = arg;
+    pool->count = count;
+    pool->chunk = chunk;
+
+    // Chunk i belongs to core i. When fewer cores than the chip has are
+    // requested and the caller sits outside [0, cores), it takes the last
+    // chunk itself.
+    uint32_t own = self < cores ? self : cores - 1;
+    uint32_t used = (count + chunk - 1) / chunk;
+    atomic_store_explicit(&pool->pending, own < used ? used - 1 : used, memory_order_relaxed);
+    for(uint32_t core = 0; core < used; core++) {
+        if(core == own) {
+            continue;
+        }
+        parallel_worker_t *worker = &pool->workers[core];
+        atomic_fetch_add(&worker->posted, 1);  // publishes the job fields above
+        if(atomic_load(&worker->parked)) {
+            xTaskNotifyGive(worker->task);
+        }
+    }
+
+    uint32_t begin, end;
+    chunk_bounds(pool, own, &begin, &end);
+    if(begin < end) {
+        fn(arg, begin, end, self);
+    }
+    while(atomic_load_explicit(&pool->pending, memory_order_acquire) != 0) {
+    }
+}
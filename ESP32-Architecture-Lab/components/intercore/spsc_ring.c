@@ -0,0 +1,45 @@
+#include <esp_heap_caps.h>
+#include "spsc_ring.h"
+
+bool spsc_ring_init(spsc_ring_t *ring, void *storage, uint32_t slot_size, uint32_t capacity) {
+    if(storage == NULL || slot_size == 0 || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+
+    ring->slots = storage;
+    ring->slot_size = slot_size;
+    ring->mask = capacity - 1;
+    ring->allocation = NULL;
+    spsc_ring_reset(ring);
+    return true;
+}
+
+spsc_ring_t *spsc_ring_create(uint32_t slot_size, uint32_t capacity, uint32_t caps) {
+    // One allocation: the ring header, then the slots on the next cache line
+    size_t header = (sizeof(spsc_ring_t) + SPSC_CACHE_LINE - 1) & ~(size_t)(SPSC_CACHE_LINE - 1);
+    uint8_t *block = heap_caps_aligned_alloc(SPSC_CACHE_LINE, header + (size_t)slot_size * capacity, caps);
+    if(block == NULL) {
+        return NULL;
+    }
+
+    spsc_ring_t *ring = (spsc_ring_t *)block;
+    if(!spsc_ring_init(ring, block + header, slot_size, capacity)) {
+        heap_caps_free(block);
+        return NULL;
+    }
+    ring->allocation = block;
+    return ring;
+}
+
+void spsc_ring_delete(spsc_ring_t *ring) {
+    if(ring && ring->allocation) {
+        heap_caps_free(ring->allocation);
+    }
+}
+
+void spsc_ring_reset(spsc_ring_t *ring) {
+    atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, 0, memory_order_relaxed);
+    ring->tail_cache = 0;
+    ring->head_cache = 0;
+}
@@ -0,0 +1,49 @@
+#include <esp_heap_caps.h>
+#include "varlen_ring.h"
+
+bool varlen_ring_init(varlen_ring_t *ring, void *storage, uint32_t size) {
+    if(storage == NULL || ((uintptr_t)storage & 3) != 0 || size < 2 * VARLEN_RING_HEADER ||
+       (size & (size - 1)) != 0) {
+        return false;
+    }
+
+    ring->buffer = storage;
+    ring->mask = size - 1;
+    ring->allocation = NULL;
+    varlen_ring_reset(ring);
+    return true;
+}
+
+varlen_ring_t *varlen_ring_create(uint32_t size, uint32_t caps) {
+    // One allocation: the ring header, then the buffer on the next cache line
+    size_t header = (sizeof(varlen_ring_t) + SPSC_CACHE_LINE - 1) & ~(size_t)(SPSC_CACHE_LINE - 1);
+    uint8_t *block = heap_caps_aligned_alloc(SPSC_CACHE_LINE, header + size, caps);
+    if(block == NULL) {
+        return NULL;
+    }
+
+    varlen_ring_t *ring = (varlen_ring_t *)block;
+    if(!varlen_ring_init(ring, block + header, size)) {
+        heap_caps_free(block);
+        return NULL;
+    }
+    ring->allocation = block;
+    return ring;
+}
+
+void varlen_ring_delete(varlen_ring_t *ring) {
+    if(ring && ring->allocation) {
+        heap_caps_free(ring->allocation);
+    }
+}
+
+void varlen_ring_reset(varlen_ring_t *ring) {
+    atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->pushed, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->popped, 0, memory_order_relaxed);
+    ring->tail_cache = 0;
+    ring->head_cache = 0;
+    ring->reserved = 0;
+    ring->next = 0;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// Memory layout and heap report (group "memory"): addresses of stack, DRAM,
+// flash and heap objects, and free sizes per heap capability.
+void memory_suite_run(void);
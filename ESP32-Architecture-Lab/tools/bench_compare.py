@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""Parse BENCH_JSON records from captured serial logs and compare runs.
+
+The firmware's JSON sink (components/bench) prints one record per line:
+
+    BENCH_JSON {"type":"result","group":"cache","name":"stride",...}
+
+Usage:
+    bench_compare.py parse LOG [-o results.json]
+    bench_compare.py compare BASELINE CURRENT [--threshold PATTERN=PCT ...]
+
+BASELINE and CURRENT may be raw serial logs or files written by `parse`.
+`compare` exits with status 1 if any metric regressed past its threshold.
+"""
+
+import argparse
+import fnmatch
+import json
+import sys
+
+PREFIX = "BENCH_JSON "
+DEFAULT_THRESHOLD_PCT = 5.0
+
+
+def read_records(path):
+    """Return the list of records in a serial log or a saved results file."""
+    with open(path, encoding="utf-8", errors="replace") as f:
+        text = f.read()
+
+    stripped = text.lstrip()
+    if stripped.startswith("["):
+        return json.loads(stripped)
+
+    records = []
+    for lineno, line in enumerate(text.splitlines(), 1):
+        index = line.find(PREFIX)
+        if index < 0:
+            continue
+        payload = line[index + len(PREFIX):].strip()
+        try:
+            records.append(json.loads(payload))
+        except json.JSONDecodeError as e:
+            # Serial captures can interleave output from both cores
+            print(f"{path}:{lineno}: skipping malformed record ({e})", file=sys.stderr)
+    return records
+
+
+def record_key(record):
+    params = record.get("params", {})
+    suffix = " ".join(f"{k}={params[k]}" for k in sorted(params))
+    key = f"{record['group']}/{record['name']}"
+    return f"{key} {suffix}" if suffix else key
+
+
+def extract_metrics(records):
+    """Flatten records to {metric_key: (value, higher_is_better)}."""
+    metrics = {}
+    for r in records:
+        kind = r.get("type")
+        if kind == "result" and not r.get("skipped"):
+            key = record_key(r)
+            metrics[f"{key} :cycles_median"] = (r["cycles"]["median"], False)
+            metrics[f"{key} :cycles_min"] = (r["cycles"]["min"], False)
+            metrics[f"{key} :cycles_p99"] = (r["cycles"]["p99"], False)
+            metrics[f"{key} :ns_per_op"] = (r["ns_per_op"], False)
+            if "mbps" in r:
+                metrics[f"{key} :mbps"] = (r["mbps"], True)
+        elif kind == "metric":
+            metrics[f"{record_key(r)} :{r['unit']}"] = (r["value"], r.get("higher_is_better", False))
+    return metrics
+
+
+def threshold_for(key, thresholds):
+    """Last matching PATTERN=PCT wins, so specific rules can follow general ones."""
+    pct = DEFAULT_THRESHOLD_PCT
+    for pattern, value in thresholds:
+        if fnmatch.fnmatchcase(key, pattern):
+            pct = value
+    return pct
+
+
+def parse_thresholds(items):
+    thresholds = []
+    for item in items or []:
+        pattern, sep, pct = item.rpartition("=")
+        if not sep:
+            raise SystemExit(f"bad threshold '{item}', expected PATTERN=PCT")
+        thresholds.append((pattern, float(pct)))
+    return thresholds
+
+
+def cmd_parse(args):
+    records = read_records(args.log)
+    out = json.dumps(records, indent=1)
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            f.write(out + "\n")
+        print(f"{len(records)} records written to {args.output}")
+    else:
+        print(out)
+    return 0
+
+
+def cmd_compare(args):
+    baseline = extract_metrics(read_records(args.baseline))
+    current = extract_metrics(read_records(args.current))
+    thresholds = parse_thresholds(args.threshold)
+
+    regressions = 0
+    rows = []
+    for key in sorted(set(baseline) | set(current)):
+        if key not in baseline:
+            rows.append(("new", key, None, current[key][0], None))
+            continue
+        if key not in current:
+            rows.append(("missing", key, baseline[key][0], None, None))
+            continue
+
+        old, higher_is_better = baseline[key]
+        new = current[key][0]
+        if old == 0:
+            change = 0.0 if new == 0 else float("inf")
+        else:
+            change = (new - old) / abs(old) * 100.0
+        worse = -change if higher_is_better else change
+        limit = threshold_for(key, thresholds)
+
+        if worse > limit:
+            status = "REGRESSED"
+            regressions += 1
+        elif worse < -limit:
+            status = "improved"
+        else:
+            status = "ok"
+        rows.append((status, key, old, new, change))
+
+    for status, key, old, new, change in rows:
+        if status == "ok" and not args.verbose:
+            continue
+        old_s = "-" if old is None else f"{old:.4g}"
+        new_s = "-" if new is None else f"{new:.4g}"
+        change_s = "" if change is None else f"{change:+.1f}%"
+        print(f"{status:10s} {key:60s} {old_s:>12s} -> {new_s:<12s} {change_s}")
+
+    compared = sum(1 for row in rows if row[4] is not None)
+    print(f"\n{compared} metrics compared, {regressions} regressed "
+          f"(default threshold {DEFAULT_THRESHOLD_PCT:g}%)")
+    return 1 if regressions else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("parse", help="extract BENCH_JSON records from a serial log")
+    p.add_argument("log")
+    p.add_argument("-o", "--output", help="write records to this file instead of stdout")
+    p.set_defaults(func=cmd_parse)
+
+    p = sub.add_parser("compare", help="diff two runs against per-metric thresholds")
+    p.add_argument("baseline")
+    p.add_argument("current")
+    p.add_argument("-t", "--threshold", action="append", metavar="PATTERN=PCT",
+                   help="allowed change for metric keys matching the glob, e.g. "
+                        "'cache/chase*:cycles_median=2' (repeatable, last match wins)")
+    p.add_argument("-v", "--verbose", action="store_true", help="also list unchanged metrics")
+    p.set_defaults(func=cmd_compare)
+
+    args = parser.parse_args()
+    return args.func(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Build the lab projects and run them unattended in QEMU.
+
+Each project is built inside the docker-compose `esp32-dev` container,
+merged into a flash image and booted in qemu-system-xtensa with -icount, so
+virtual time advances per executed instruction and the timing reported by
+the firmware is the same on every run. UART output is captured until the
+firmware prints BENCH_DONE (components/bench) or the timeout expires.
+cache-test-psram is cache-test built with PSRAM enabled
+(cache-test/sdkconfig.defaults.psram) in its own build directory.
+
+For each project this writes, under --results (default results/<timestamp>/):
+    <project>.log    raw serial capture
+    <project>.json   BENCH_JSON records (see bench_compare.py)
+
+Usage:
+    run_qemu_bench.py [PROJECT ...] [--icount-shift N] [--timeout S]
+                      [--baseline DIR] [--save-baseline DIR]
+"""
+
+import argparse
+import datetime
+import json
+import os
+import shutil
+import subprocess
+import sys
+import threading
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import bench_compare  # noqa: E402
+
+LAB_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+COMPOSE_FILE = os.path.join(LAB_DIR, "docker-compose.yml")
+SERVICE = "esp32-dev"
+CONTAINER_ROOT = "/project"  # docker-compose.yml mounts the lab directory here
+PROJECTS = ["memory-test", "cache-test", "cache-test-psram", "dual-core-test"]
+# Build variants: name -> (project directory, defaults file layered on its
+# sdkconfig, build directory)
+VARIANTS = {"cache-test-psram": ("cache-test", "sdkconfig.defaults.psram", "build/psram")}
+DONE_MARKER = "BENCH_DONE"
+FLASH_SIZE = "2MB"  # CONFIG_ESPTOOLPY_FLASHSIZE in the projects' sdkconfig
+
+
+def compose(*args):
+    return ["docker", "compose", "-f", COMPOSE_FILE, *args]
+
+
+def in_container(script, **kwargs):
+    """Run a bash script in the dev container with the IDF environment loaded."""
+    cmd = compose("exec", "-T", SERVICE, "bash", "-c", f"source $IDF_PATH/export.sh >/dev/null && {script}")
+    return subprocess.run(cmd, **kwargs)
+
+
+def ensure_container():
+    subprocess.run(compose("up", "-d", SERVICE), check=True)
+    # The IDF image does not ship QEMU by default
+    in_container("command -v qemu-system-xtensa >/dev/null || "
+                 "python $IDF_PATH/tools/idf_tools.py install qemu-xtensa", check=True)
+
+
+def build_dir(project):
+    """(project directory, build directory inside it) of a project or variant."""
+    if project in VARIANTS:
+        return VARIANTS[project][0], VARIANTS[project][2]
+    return project, "build"
+
+
+def build(project):
+    print(f"[{project}] building", flush=True)
+    directory, build_path = build_dir(project)
+    idf = "idf.py"
+    if project in VARIANTS:
+        # Separate build directory and sdkconfig, so the checked-in one is
+        # only read, as the first defaults file
+        idf = (f"idf.py -B {build_path} -D SDKCONFIG={build_path}/sdkconfig "
+               f"-D SDKCONFIG_DEFAULTS='sdkconfig;{VARIANTS[project][1]}'")
+    script = (f"cd {CONTAINER_ROOT}/{directory} && {idf} build && cd {build_path} && "
+              f"esptool.py --chip esp32 merge_bin --fill-flash-size {FLASH_SIZE} "
+              f"-o qemu_flash.bin @flash_args")
+    result = in_container(script)
+    if result.returncode != 0:
+        raise RuntimeError(f"{project}: build failed")
+
+
+def run_qemu(project, icount_shift, timeout, log_path):
+    """Boot the merged image; return (captured lines, True if DONE_MARKER seen)."""
+    directory, build_path = build_dir(project)
+    image = f"{CONTAINER_ROOT}/{directory}/{build_path}/qemu_flash.bin"
+    # shift=N: each instruction advances virtual time by 2^N ns.
+    # sleep=off: idle time (vTaskDelay) is skipped rather than waited out in real time.
+    qemu = (f"qemu-system-xtensa -nographic -machine esp32 -m 4M "
+            f"-icount shift={icount_shift},align=off,sleep=off -rtc clock=vm "
+            f"-drive file={image},if=mtd,format=raw")
+    # `exec` so the pkill below hits QEMU itself
+    cmd = compose("exec", "-T", SERVICE, "bash", "-c", f"source $IDF_PATH/export.sh >/dev/null && exec {qemu}")
+
+    print(f"[{project}] booting in QEMU (icount shift={icount_shift}, timeout {timeout}s)", flush=True)
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            text=True, errors="replace", bufsize=1)
+
+    def on_timeout():
+        # Killing QEMU closes its stdout, which unblocks the read loop below
+        in_container("pkill -f qemu-system-xtensa || true")
+
+    timer = threading.Timer(timeout, on_timeout)
+    timer.start()
+
+    lines = []
+    done = False  # stays False if the timeout fired first
+    with open(log_path, "w", encoding="utf-8") as log:
+        for line in proc.stdout:
+            log.write(line)
+            lines.append(line)
+            if DONE_MARKER in line:
+                done = True
+                break
+    timer.cancel()
+
+    # QEMU never exits on its own; stop it inside the container
+    in_container("pkill -f qemu-system-xtensa || true")
+    try:
+        proc.wait(timeout=10)
+    except subprocess.TimeoutExpired:
+        proc.kill()
+    return lines, done
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("projects", nargs="*", default=PROJECTS, help=f"default: {' '.join(PROJECTS)}")
+    parser.add_argument("--icount-shift", type=int, default=3,
+                        help="virtual ns per instruction as a power of two (3 = 8 ns, ~125 MIPS)")
+    parser.add_argument("--timeout", type=float, default=900.0, help="seconds of wall time per project")
+    parser.add_argument("--results", help="output directory (default results/<timestamp>)")
+    parser.add_argument("--no-build", action="store_true", help="reuse existing build/qemu_flash.bin")
+    parser.add_argument("--baseline", help="directory of <project>.json files to compare against")
+    parser.add_argument("--save-baseline", help="copy this run's <project>.json files here")
+    parser.add_argument("-t", "--threshold", action="append", metavar="PATTERN=PCT",
+                        help="passed to bench_compare.py compare")
+    args = parser.parse_args()
+
+    stamp = datetime.datetime.now().strftime("%Y%m%d-%H%M%S")
+    results = args.results or os.path.join(LAB_DIR, "results", stamp)
+    os.makedirs(results, exist_ok=True)
+
+    ensure_container()
+    failures = 0
+    for project in args.projects:
+        log_path = os.path.join(results, f"{project}.log")
+        json_path = os.path.join(results, f"{project}.json")
+        try:
+            if not args.no_build:
+                build(project)
+            _, done = run_qemu(project, args.icount_shift, args.timeout, log_path)
+        except RuntimeError as e:
+            print(e, file=sys.stderr)
+            failures += 1
+            continue
+
+        records = bench_compare.read_records(log_path)
+        with open(json_path, "w", encoding="utf-8") as f:
+            json.dump(records, f, indent=1)
+            f.write("\n")
+        status = "complete" if done else "TIMED OUT"
+        print(f"[{project}] {status}: {len(records)} records -> {json_path}", flush=True)
+        if not done:
+            failures += 1
+            continue
+
+        if args.save_baseline:
+            os.makedirs(args.save_baseline, exist_ok=True)
+            shutil.copy(json_path, os.path.join(args.save_baseline, f"{project}.json"))
+
+        if args.baseline:
+            baseline_path = os.path.join(args.baseline, f"{project}.json")
+            if not os.path.exists(baseline_path):
+                print(f"[{project}] no baseline at {baseline_path}")
+                continue
+            compare_args = argparse.Namespace(baseline=baseline_path, current=json_path,
+                                              threshold=args.threshold, verbose=False)
+            print(f"[{project}] comparing against {baseline_path}")
+            if bench_compare.cmd_compare(compare_args) != 0:
+                failures += 1
+
+    print(f"\nResults in {results}")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())